@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    BlockTimingStats.h
+
+    Instrumentación del coste de processBlock en el audio thread:
+    histograma logarítmico del tiempo por bloque, peor caso, media y bloques
+    fuera de plazo (más lentos que la duración del propio bloque).
+
+    Un único escritor (audio thread) y cualquier número de lectores: todo son
+    atómicos relaxed, sin bloqueos ni reservas de memoria.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class BlockTimingStats
+{
+public:
+    // Bins de media octava sobre nanosegundos: 2 bins por potencia de 2 hasta ~4 s
+    static constexpr int numBins = 64;
+
+    //==============================================================================
+    // Audio thread: registra un bloque de numSamples que tardó elapsedTicks
+    void record (juce::int64 elapsedTicks, int numSamples, double sampleRate) noexcept
+    {
+        const double nanos = juce::Time::highResolutionTicksToSeconds (elapsedTicks) * 1.0e9;
+        const auto ns = (juce::uint64) juce::jlimit (0.0, 4294967295.0, nanos);
+
+        increment (bins[binForNanos ((juce::uint32) ns)]);
+        increment (numBlocks);
+        add (totalNanos, ns);
+
+        if (ns > worstNanos.load (std::memory_order_relaxed))
+            worstNanos.store (ns, std::memory_order_relaxed);
+
+        // Plazo: el bloque debe procesarse en menos tiempo del que dura
+        if (sampleRate > 0.0 && nanos > (double) numSamples * 1.0e9 / sampleRate)
+            increment (deadlineMisses);
+    }
+
+    // Cualquier hilo (no en paralelo con record)
+    void reset() noexcept
+    {
+        for (auto& b : bins)
+            b.store (0, std::memory_order_relaxed);
+
+        numBlocks.store (0, std::memory_order_relaxed);
+        totalNanos.store (0, std::memory_order_relaxed);
+        worstNanos.store (0, std::memory_order_relaxed);
+        deadlineMisses.store (0, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    // Copia coherente "a grandes rasgos" para la GUI o las herramientas
+    struct Snapshot
+    {
+        juce::uint64 bins[numBins] = {};
+        juce::uint64 numBlocks = 0, deadlineMisses = 0;
+        double meanMicros = 0.0, worstMicros = 0.0;
+
+        // Percentil aproximado (borde superior del bin), en microsegundos
+        double getPercentileMicros (double percentile) const noexcept
+        {
+            const auto target = (juce::uint64) std::ceil (juce::jlimit (0.0, 1.0, percentile) * (double) numBlocks);
+            juce::uint64 accumulated = 0;
+
+            for (int b = 0; b < numBins; ++b)
+            {
+                accumulated += bins[b];
+
+                if (accumulated >= target && accumulated > 0)
+                    return binUpperEdgeNanos (b) * 1.0e-3;
+            }
+
+            return worstMicros;
+        }
+
+        // Acumula otra instantánea (p. ej. de otra instancia o de otro worker)
+        void merge (const Snapshot& other) noexcept
+        {
+            const auto total = numBlocks + other.numBlocks;
+
+            if (total > 0)
+                meanMicros = (meanMicros * (double) numBlocks + other.meanMicros * (double) other.numBlocks) / (double) total;
+
+            for (int b = 0; b < numBins; ++b)
+                bins[b] += other.bins[b];
+
+            numBlocks       = total;
+            deadlineMisses += other.deadlineMisses;
+            worstMicros     = juce::jmax (worstMicros, other.worstMicros);
+        }
+
+        juce::var toVar() const
+        {
+            auto* obj = new juce::DynamicObject();
+            obj->setProperty ("blocks",         (juce::int64) numBlocks);
+            obj->setProperty ("deadlineMisses", (juce::int64) deadlineMisses);
+            obj->setProperty ("meanMicros",     meanMicros);
+            obj->setProperty ("p50Micros",      getPercentileMicros (0.50));
+            obj->setProperty ("p99Micros",      getPercentileMicros (0.99));
+            obj->setProperty ("worstMicros",    worstMicros);
+
+            juce::Array<juce::var> histogram;
+            for (int b = 0; b < numBins; ++b)
+                if (bins[b] > 0)
+                    histogram.add (juce::Array<juce::var> { binUpperEdgeNanos (b) * 1.0e-3, (juce::int64) bins[b] });
+
+            obj->setProperty ("histogramMicros", histogram);
+            return juce::var (obj);
+        }
+    };
+
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot s;
+
+        for (int b = 0; b < numBins; ++b)
+            s.bins[b] = bins[b].load (std::memory_order_relaxed);
+
+        s.numBlocks      = numBlocks.load (std::memory_order_relaxed);
+        s.deadlineMisses = deadlineMisses.load (std::memory_order_relaxed);
+        s.worstMicros    = (double) worstNanos.load (std::memory_order_relaxed) * 1.0e-3;
+        s.meanMicros     = s.numBlocks > 0 ? (double) totalNanos.load (std::memory_order_relaxed) * 1.0e-3 / (double) s.numBlocks
+                                           : 0.0;
+        return s;
+    }
+
+    //==============================================================================
+    // Mide el bloque en curso; el destructor lo registra
+    struct ScopedBlockTimer
+    {
+        ScopedBlockTimer (BlockTimingStats& s, int samples, double rate) noexcept
+            : stats (s), numSamples (samples), sampleRate (rate),
+              start (juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedBlockTimer()
+        {
+            stats.record (juce::Time::getHighResolutionTicks() - start, numSamples, sampleRate);
+        }
+
+        BlockTimingStats& stats;
+        const int numSamples;
+        const double sampleRate;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlockTimer)
+    };
+
+private:
+    static int binForNanos (juce::uint32 ns) noexcept
+    {
+        if (ns < 2)
+            return 0;
+
+        const int msb = juce::findHighestSetBit (ns);
+        return 2 * msb + (int) ((ns >> (msb - 1)) & 1u);
+    }
+
+    static double binUpperEdgeNanos (int bin) noexcept
+    {
+        const int msb = bin / 2;
+        const double octave = std::ldexp (1.0, msb);
+        return octave + (double) ((bin & 1) + 1) * octave * 0.5;
+    }
+
+    // Un solo escritor: load + store evita instrucciones con lock
+    static void increment (std::atomic<juce::uint64>& value) noexcept
+    {
+        value.store (value.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static void add (std::atomic<juce::uint64>& value, juce::uint64 amount) noexcept
+    {
+        value.store (value.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    std::atomic<juce::uint64> bins[numBins] {};
+    std::atomic<juce::uint64> numBlocks { 0 }, totalNanos { 0 }, worstNanos { 0 }, deadlineMisses { 0 };
+};
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+
+    Divisor en bandas Linkwitz-Riley de 4º orden (24 dB/oct) para el modo
+    multibanda de la puerta. Con las bandas b0..bN-1 y los cortes f1 < f2 < f3:
+
+        b0 = LP1(x)            -> AP2 -> AP3
+        b1 = LP2(HP1(x))       -> AP3
+        b2 = LP3(HP2(HP1(x)))
+        b3 = HP3(HP2(HP1(x)))
+
+    LP_k + HP_k de un LR4 es el paso todo de 2º orden AP_k (Q = 1/sqrt(2)).
+    Pasar las bandas bajas por los paso todo de los cortes superiores deja
+    todas las bandas con la misma fase, así que la suma es plana en magnitud
+    (x filtrada por AP1·AP2·AP3), sin latencia añadida.
+
+    Cada filtro es un BiquadCascade: coeficientes compartidos, estado por
+    canal, etapas fusionadas en un solo bucle por bloque (como KeyFilter).
+    Los cortes se suavizan con una rampa multiplicativa y los coeficientes
+    se recalculan por tramo mientras dura. Sin reservas fuera de prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Cascada de NumStages biquads (TDF-II) con estado independiente por canal
+template <typename SampleType, int NumStages>
+class BiquadCascade
+{
+public:
+    struct Coefficients
+    {
+        SampleType b0 = SampleType (1), b1 = SampleType (0), b2 = SampleType (0);
+        SampleType a1 = SampleType (0), a2 = SampleType (0);
+    };
+
+    enum class Type { lowPass, highPass, allPass };
+
+    void prepare (int maxChannels)
+    {
+        numChannels = juce::jmax (1, maxChannels);
+        state.allocate ((size_t) (NumStages * 2 * numChannels), true);
+    }
+
+    void reset() noexcept
+    {
+        if (state != nullptr)
+            juce::FloatVectorOperations::clear (state.get(), NumStages * 2 * numChannels);
+    }
+
+    // Todas las etapas iguales: Butterworth de 2º orden (Q = 1/sqrt(2)) del tipo dado
+    void setButterworth (Type type, double frequencyHz, double sampleRate) noexcept
+    {
+        const double w0    = juce::MathConstants<double>::twoPi * frequencyHz / sampleRate;
+        const double cosW  = std::cos (w0);
+        const double alpha = std::sin (w0) / juce::MathConstants<double>::sqrt2;   // sin / (2Q)
+        const double a0    = 1.0 + alpha;
+
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+
+        switch (type)
+        {
+            case Type::lowPass:   b0 = (1.0 - cosW) * 0.5;  b1 = 1.0 - cosW;     b2 = b0;          break;
+            case Type::highPass:  b0 = (1.0 + cosW) * 0.5;  b1 = -(1.0 + cosW);  b2 = b0;          break;
+            case Type::allPass:   b0 = 1.0 - alpha;         b1 = -2.0 * cosW;    b2 = 1.0 + alpha; break;
+        }
+
+        Coefficients c;
+        c.b0 = (SampleType) (b0 / a0);
+        c.b1 = (SampleType) (b1 / a0);
+        c.b2 = (SampleType) (b2 / a0);
+        c.a1 = (SampleType) (-2.0 * cosW / a0);
+        c.a2 = (SampleType) ((1.0 - alpha) / a0);
+
+        for (auto& stage : coefficients)
+            stage = c;
+    }
+
+    // Filtra un canal por bloque, todas las etapas en el mismo bucle (out puede ser in)
+    void process (int channel, const SampleType* in, SampleType* out, int numSamples) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (channel, numChannels));
+
+        SampleType z1[NumStages], z2[NumStages];
+
+        for (int s = 0; s < NumStages; ++s)
+        {
+            z1[s] = stateAt (s, 0, channel);
+            z2[s] = stateAt (s, 1, channel);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            SampleType x = in[i];
+
+            for (int s = 0; s < NumStages; ++s)
+            {
+                const auto& c = coefficients[s];
+                const SampleType y = c.b0 * x + z1[s];
+                z1[s] = c.b1 * x - c.a1 * y + z2[s];
+                z2[s] = c.b2 * x - c.a2 * y;
+                x = y;
+            }
+
+            out[i] = x;
+        }
+
+        for (int s = 0; s < NumStages; ++s)
+        {
+            stateAt (s, 0, channel) = z1[s];
+            stateAt (s, 1, channel) = z2[s];
+        }
+    }
+
+private:
+    SampleType& stateAt (int stage, int index, int channel) noexcept
+    {
+        return state[(stage * 2 + index) * numChannels + channel];
+    }
+
+    Coefficients coefficients[NumStages];
+    juce::HeapBlock<SampleType> state;   // [etapa][z1/z2][canal]
+    int numChannels = 1;
+};
+
+//==============================================================================
+template <typename SampleType>
+class LinkwitzRileySplitter
+{
+public:
+    static constexpr int maxBands      = 4;
+    static constexpr int maxCrossovers = maxBands - 1;
+
+    static constexpr float minFrequencyHz = 20.0f;
+    static constexpr float maxFrequencyHz = 20000.0f;
+
+    // Separación mínima entre cortes consecutivos (factor de frecuencia)
+    static constexpr float minCrossoverRatio = 1.25f;
+
+    static constexpr double smoothingSeconds = 0.05;
+
+    //==============================================================================
+    void prepare (double newSampleRate, int maxChannels)
+    {
+        sampleRate  = newSampleRate;
+        numChannels = juce::jmax (1, maxChannels);
+
+        for (int k = 0; k < maxCrossovers; ++k)
+        {
+            lowPass[k].prepare (numChannels);
+            highPass[k].prepare (numChannels);
+            allPass[k].prepare (numChannels);
+            frequencies[k].reset (sampleRate, smoothingSeconds);
+        }
+
+        numBands = 0;   // el primer setCrossovers salta sin rampa
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (int k = 0; k < maxCrossovers; ++k)
+        {
+            lowPass[k].reset();
+            highPass[k].reset();
+            allPass[k].reset();
+        }
+    }
+
+    // Número de bandas (2..maxBands) y cortes en Hz (numBands - 1 valores).
+    // Los cortes se ordenan y separan al menos minCrossoverRatio.
+    void setCrossovers (int newNumBands, const float* crossoverHz) noexcept
+    {
+        newNumBands = juce::jlimit (2, maxBands, newNumBands);
+
+        const float maxHz = juce::jmin (maxFrequencyHz, (float) (0.45 * sampleRate));
+        float previous = 0.0f;
+
+        for (int k = 0; k < newNumBands - 1; ++k)
+        {
+            float target = juce::jlimit (minFrequencyHz, maxHz, crossoverHz[k]);
+            target = juce::jmin (maxHz, juce::jmax (target, previous * minCrossoverRatio));
+            previous = target;
+
+            if (newNumBands != numBands)
+                frequencies[k].setCurrentAndTargetValue (target);
+            else
+                frequencies[k].setTargetValue (target);
+        }
+
+        // Cambiar la topología invalida el estado de los filtros
+        if (newNumBands != numBands)
+        {
+            numBands = newNumBands;
+            reset();
+            updateCoefficients();
+        }
+    }
+
+    int getNumBands() const noexcept  { return numBands; }
+
+    bool isSmoothing() const noexcept
+    {
+        for (int k = 0; k < numBands - 1; ++k)
+            if (frequencies[k].isSmoothing())
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    // Divide numSamples muestras de numChannels canales en numBands bandas:
+    // bands[b][ch] recibe la banda b del canal ch (ya compensada en fase).
+    void split (const SampleType* const* input, SampleType* const* const* bands, int numSamples) noexcept
+    {
+        if (isSmoothing())
+        {
+            for (int k = 0; k < numBands - 1; ++k)
+                frequencies[k].skip (numSamples);
+
+            updateCoefficients();
+        }
+
+        const int last = numBands - 1;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            // El resto (parte alta) viaja en la banda más alta y se va partiendo
+            const SampleType* rest = input[ch];
+
+            for (int k = 0; k < last; ++k)
+            {
+                lowPass[k].process (ch, rest, bands[k][ch], numSamples);
+                highPass[k].process (ch, rest, bands[last][ch], numSamples);
+                rest = bands[last][ch];
+
+                // Compensación de fase: las bandas inferiores pasan por AP_k
+                for (int b = 0; b < k; ++b)
+                    allPassFor (k, b).process (ch, bands[b][ch], bands[b][ch], numSamples);
+            }
+        }
+    }
+
+private:
+    // Un paso todo por (corte, banda inferior): cada uno lleva su propio estado
+    BiquadCascade<SampleType, 1>& allPassFor (int crossover, int band) noexcept
+    {
+        // Pares (k, b) con b < k: (1,0) (2,0) (2,1)
+        return crossover == 1 ? allPass[0] : allPass[1 + band];
+    }
+
+    void updateCoefficients() noexcept
+    {
+        using Type = typename BiquadCascade<SampleType, 2>::Type;
+        using AllPassType = typename BiquadCascade<SampleType, 1>::Type;
+
+        for (int k = 0; k < numBands - 1; ++k)
+        {
+            const double f = frequencies[k].getCurrentValue();
+            lowPass[k].setButterworth (Type::lowPass, f, sampleRate);
+            highPass[k].setButterworth (Type::highPass, f, sampleRate);
+        }
+
+        if (numBands > 2)
+            allPass[0].setButterworth (AllPassType::allPass, frequencies[1].getCurrentValue(), sampleRate);
+
+        if (numBands > 3)
+            for (int b = 0; b < 2; ++b)
+                allPass[1 + b].setButterworth (AllPassType::allPass, frequencies[2].getCurrentValue(), sampleRate);
+    }
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    int numChannels   = 1;
+    int numBands      = 0;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> frequencies[maxCrossovers];
+
+    BiquadCascade<SampleType, 2> lowPass[maxCrossovers];    // LR4 = 2 Butterworth en cascada
+    BiquadCascade<SampleType, 2> highPass[maxCrossovers];
+    BiquadCascade<SampleType, 1> allPass[maxCrossovers];    // (1,0) (2,0) (2,1)
+};
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    FactoryPresets.h
+
+    Banco de programas de fábrica de SilentRoom. Cada programa lista solo
+    los parámetros que cambia (en unidades reales, como en el APVTS); el
+    resto vuelve a su valor por defecto al cargarlo, así que ningún ajuste
+    del programa anterior se queda "pegado".
+
+    Los valores se aplican desde el message thread como un único conjunto
+    (ver SilentRoomAudioProcessor::setCurrentProgram): el audio thread ve el
+    programa anterior o el nuevo completo, nunca una mezcla. THRESHOLD,
+    RATIO y los cortes de la multibanda ya se suavizan en los motores.
+
+    Un programa que cambia BANDS o MODE cambia de motor: el saliente sigue
+    sonando hasta que el entrante llena su retardo y se funden en 10 ms
+    (GateEngines::crossfadeMs). Si la latencia cambia, el host la compensa
+    después del cambio, así que el paso entre modos no es idéntico a la
+    muestra, pero no deja huecos de silencio ni cortes bruscos.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace FactoryPresets
+{
+    struct Value
+    {
+        const char* parameterID;
+        float value;   // unidades reales (dB, ms, Hz, índice de elección...)
+    };
+
+    struct Program
+    {
+        const char* name;
+        std::vector<Value> values;
+    };
+
+    // El índice en este array es el número de programa que ve el host
+    inline const std::array<Program, 7>& getPrograms()
+    {
+        static const std::array<Program, 7> programs {{
+            { "Default", {} },
+
+            { "Vocal - Gentle",
+              { { "THRESHOLD", -45.0f }, { "RATIO", 4.0f }, { "ATTACK", 5.0f }, { "RELEASE", 200.0f },
+                { "LOOKAHEAD", 2.0f }, { "DETECTOR", 1.0f }, { "RMS_WINDOW", 10.0f },
+                { "HOLD", 40.0f }, { "HYSTERESIS", 4.0f }, { "KNEE", 6.0f }, { "RANGE", 20.0f } } },
+
+            { "Vocal - Home Studio",
+              { { "THRESHOLD", -50.0f }, { "RATIO", 10.0f }, { "ATTACK", 2.0f }, { "RELEASE", 150.0f },
+                { "KEY_FILTER", 1.0f }, { "KEY_FREQ", 120.0f }, { "HOLD", 50.0f }, { "HYSTERESIS", 6.0f },
+                { "KNEE", 3.0f }, { "RANGE", 40.0f } } },
+
+            { "Drums - Snare/Toms",
+              { { "THRESHOLD", -30.0f }, { "RATIO", 50.0f }, { "ATTACK", 1.0f }, { "RELEASE", 80.0f },
+                { "LOOKAHEAD", 1.0f }, { "KEY_FILTER", 3.0f }, { "KEY_FREQ", 200.0f }, { "HOLD", 15.0f } } },
+
+            { "Podcast - HVAC Rumble",
+              { { "ATTACK", 5.0f }, { "RELEASE", 150.0f }, { "BANDS", 1.0f }, { "XOVER_1", 200.0f },
+                { "THRESHOLD_B1", -40.0f }, { "RATIO_B1", 20.0f },
+                { "THRESHOLD_B2", -50.0f }, { "RATIO_B2", 4.0f } } },
+
+            { "Broadband Noise - Spectral",
+              { { "MODE", 1.0f }, { "SPECTRAL_OFFSET", 12.0f }, { "RATIO", 4.0f },
+                { "ATTACK", 5.0f }, { "RELEASE", 100.0f }, { "RANGE", 24.0f } } },
+
+            { "Room Mic - External Key",
+              { { "SIDECHAIN", 1.0f }, { "THRESHOLD", -40.0f }, { "RATIO", 20.0f },
+                { "ATTACK", 2.0f }, { "RELEASE", 250.0f }, { "HOLD", 30.0f },
+                { "RANGE", 30.0f } } },
+        }};
+
+        return programs;
+    }
+}
@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+
+    Conversiones dB <-> lineal aproximadas para el gain computer.
+    log2/exp2 por manipulación de bits + polinomio, en forma escalar y SIMD
+    (SSE2 / NEON, con bucle escalar como alternativa genérica).
+
+    Precisión (barrido -100..0 dB, ver measureAccuracy):
+      - gainToDecibels: error máximo ~1e-4 dB
+      - decibelsToGain: error máximo ~4e-5 dB
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SILENTROOM_FASTMATH_SSE2 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define SILENTROOM_FASTMATH_NEON 1
+#endif
+
+namespace FastMath
+{
+    // Suelo de la conversión (mismo criterio que juce::Decibels)
+    static constexpr float kMinusInfinityDb = -100.0f;
+
+    // 20 * log10 (2) y su inverso: dB = log2 (g) * kDbPerLog2
+    static constexpr float kDbPerLog2 = 6.0205999132796239f;
+    static constexpr float kLog2PerDb = 0.16609640474436813f;
+
+    // --- Coeficientes (mínimos cuadrados sobre nodos de Chebyshev) ---
+    // log2 (1 + t) ~= t * (L1 + t * (L2 + t * (L3 + t * (L4 + t * L5)))),  t en [0, 1)
+    static constexpr float kLog2C1 =  1.4418798958677106f;
+    static constexpr float kLog2C2 = -0.7088652182654335f;
+    static constexpr float kLog2C3 =  0.4152455618753935f;
+    static constexpr float kLog2C4 = -0.19351652627683635f;
+    static constexpr float kLog2C5 =  0.04526829326040247f;
+
+    // 2^f ~= 1 + f * (E1 + f * (E2 + f * (E3 + f * E4))),  f en [0, 1)
+    static constexpr float kExp2C1 = 0.6930175128643769f;
+    static constexpr float kExp2C2 = 0.24144865969502272f;
+    static constexpr float kExp2C3 = 0.05194795276079157f;
+    static constexpr float kExp2C4 = 0.01358166409031842f;
+
+    //==============================================================================
+    // --- Kernels escalares ---
+
+    // log2 aproximado. Requiere x > 0 y normal (el detector garantiza >= 1e-10).
+    inline float log2 (float x) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy (&bits, &x, sizeof (bits));
+
+        const int exponent = static_cast<int> ((bits >> 23) & 0xffu) - 127;
+        bits = (bits & 0x007fffffu) | 0x3f800000u;   // mantisa en [1, 2)
+
+        float mantissa;
+        std::memcpy (&mantissa, &bits, sizeof (mantissa));
+
+        const float t = mantissa - 1.0f;
+        return static_cast<float> (exponent)
+             + t * (kLog2C1 + t * (kLog2C2 + t * (kLog2C3 + t * (kLog2C4 + t * kLog2C5))));
+    }
+
+    // 2^x aproximado. Válido en [-126, 127].
+    inline float exp2 (float x) noexcept
+    {
+        const float whole = std::floor (x);
+        const float f = x - whole;
+
+        const std::uint32_t bits = static_cast<std::uint32_t> (static_cast<int> (whole) + 127) << 23;
+        float scale;
+        std::memcpy (&scale, &bits, sizeof (scale));
+
+        return scale * (1.0f + f * (kExp2C1 + f * (kExp2C2 + f * (kExp2C3 + f * kExp2C4))));
+    }
+
+    // Equivalentes rápidos de juce::Decibels con suelo en -100 dB
+    inline float gainToDecibels (float gain) noexcept
+    {
+        return gain > 0.0f ? juce::jmax (kMinusInfinityDb, log2 (gain) * kDbPerLog2)
+                           : kMinusInfinityDb;
+    }
+
+    inline float decibelsToGain (float decibels) noexcept
+    {
+        return decibels > kMinusInfinityDb ? exp2 (decibels * kLog2PerDb) : 0.0f;
+    }
+
+    //==============================================================================
+    // --- Kernels por bloque (SIMD) ---
+
+    // dest[i] = gainToDecibels (src[i]). Requiere src[i] > 0 (nivel ya protegido).
+    inline void gainToDecibels (float* dest, const float* src, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if SILENTROOM_FASTMATH_SSE2
+        const __m128i mantissaMask = _mm_set1_epi32 (0x007fffff);
+        const __m128i oneBits      = _mm_set1_epi32 (0x3f800000);
+        const __m128i bias         = _mm_set1_epi32 (127);
+        const __m128  one          = _mm_set1_ps (1.0f);
+        const __m128  floorDb      = _mm_set1_ps (kMinusInfinityDb);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128i bits = _mm_castps_si128 (_mm_loadu_ps (src + i));
+            const __m128  exponent = _mm_cvtepi32_ps (_mm_sub_epi32 (_mm_srli_epi32 (bits, 23), bias));
+            const __m128  t = _mm_sub_ps (_mm_castsi128_ps (_mm_or_si128 (_mm_and_si128 (bits, mantissaMask), oneBits)), one);
+
+            __m128 p = _mm_set1_ps (kLog2C5);
+            p = _mm_add_ps (_mm_mul_ps (p, t), _mm_set1_ps (kLog2C4));
+            p = _mm_add_ps (_mm_mul_ps (p, t), _mm_set1_ps (kLog2C3));
+            p = _mm_add_ps (_mm_mul_ps (p, t), _mm_set1_ps (kLog2C2));
+            p = _mm_add_ps (_mm_mul_ps (p, t), _mm_set1_ps (kLog2C1));
+
+            const __m128 log2Value = _mm_add_ps (exponent, _mm_mul_ps (p, t));
+            _mm_storeu_ps (dest + i, _mm_max_ps (floorDb, _mm_mul_ps (log2Value, _mm_set1_ps (kDbPerLog2))));
+        }
+       #elif SILENTROOM_FASTMATH_NEON
+        const uint32x4_t mantissaMask = vdupq_n_u32 (0x007fffffu);
+        const uint32x4_t oneBits      = vdupq_n_u32 (0x3f800000u);
+        const int32x4_t  bias         = vdupq_n_s32 (127);
+        const float32x4_t one         = vdupq_n_f32 (1.0f);
+        const float32x4_t floorDb     = vdupq_n_f32 (kMinusInfinityDb);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const uint32x4_t bits = vreinterpretq_u32_f32 (vld1q_f32 (src + i));
+            const float32x4_t exponent = vcvtq_f32_s32 (vsubq_s32 (vreinterpretq_s32_u32 (vshrq_n_u32 (bits, 23)), bias));
+            const float32x4_t t = vsubq_f32 (vreinterpretq_f32_u32 (vorrq_u32 (vandq_u32 (bits, mantissaMask), oneBits)), one);
+
+            float32x4_t p = vdupq_n_f32 (kLog2C5);
+            p = vmlaq_f32 (vdupq_n_f32 (kLog2C4), p, t);
+            p = vmlaq_f32 (vdupq_n_f32 (kLog2C3), p, t);
+            p = vmlaq_f32 (vdupq_n_f32 (kLog2C2), p, t);
+            p = vmlaq_f32 (vdupq_n_f32 (kLog2C1), p, t);
+
+            const float32x4_t log2Value = vmlaq_f32 (exponent, p, t);
+            vst1q_f32 (dest + i, vmaxq_f32 (floorDb, vmulq_f32 (log2Value, vdupq_n_f32 (kDbPerLog2))));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            dest[i] = gainToDecibels (src[i]);
+    }
+
+    // dest[i] = decibelsToGain (src[i]). Pensado para GR en [-100, 0] dB.
+    inline void decibelsToGain (float* dest, const float* src, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if SILENTROOM_FASTMATH_SSE2
+        const __m128  floorDb   = _mm_set1_ps (kMinusInfinityDb);
+        const __m128  log2PerDb = _mm_set1_ps (kLog2PerDb);
+        const __m128  one       = _mm_set1_ps (1.0f);
+        const __m128i bias      = _mm_set1_epi32 (127);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 decibels = _mm_loadu_ps (src + i);
+            const __m128 x = _mm_mul_ps (_mm_max_ps (decibels, floorDb), log2PerDb);
+
+            // floor() con SSE2: truncar y corregir los negativos no enteros
+            __m128i whole = _mm_cvttps_epi32 (x);
+            whole = _mm_add_epi32 (whole, _mm_castps_si128 (_mm_cmpgt_ps (_mm_cvtepi32_ps (whole), x)));
+            const __m128 f = _mm_sub_ps (x, _mm_cvtepi32_ps (whole));
+            const __m128 scale = _mm_castsi128_ps (_mm_slli_epi32 (_mm_add_epi32 (whole, bias), 23));
+
+            __m128 p = _mm_set1_ps (kExp2C4);
+            p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (kExp2C3));
+            p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (kExp2C2));
+            p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (kExp2C1));
+            p = _mm_add_ps (_mm_mul_ps (p, f), one);
+
+            // Por debajo del suelo la ganancia es exactamente 0 (como juce::Decibels)
+            const __m128 aboveFloor = _mm_cmpgt_ps (decibels, floorDb);
+            _mm_storeu_ps (dest + i, _mm_and_ps (aboveFloor, _mm_mul_ps (scale, p)));
+        }
+       #elif SILENTROOM_FASTMATH_NEON
+        const float32x4_t floorDb   = vdupq_n_f32 (kMinusInfinityDb);
+        const float32x4_t log2PerDb = vdupq_n_f32 (kLog2PerDb);
+        const float32x4_t one       = vdupq_n_f32 (1.0f);
+        const int32x4_t   bias      = vdupq_n_s32 (127);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const float32x4_t decibels = vld1q_f32 (src + i);
+            const float32x4_t x = vmulq_f32 (vmaxq_f32 (decibels, floorDb), log2PerDb);
+
+            int32x4_t whole = vcvtq_s32_f32 (x);
+            whole = vaddq_s32 (whole, vreinterpretq_s32_u32 (vcgtq_f32 (vcvtq_f32_s32 (whole), x)));
+            const float32x4_t f = vsubq_f32 (x, vcvtq_f32_s32 (whole));
+            const float32x4_t scale = vreinterpretq_f32_s32 (vshlq_n_s32 (vaddq_s32 (whole, bias), 23));
+
+            float32x4_t p = vdupq_n_f32 (kExp2C4);
+            p = vmlaq_f32 (vdupq_n_f32 (kExp2C3), p, f);
+            p = vmlaq_f32 (vdupq_n_f32 (kExp2C2), p, f);
+            p = vmlaq_f32 (vdupq_n_f32 (kExp2C1), p, f);
+            p = vmlaq_f32 (one, p, f);
+
+            const uint32x4_t aboveFloor = vcgtq_f32 (decibels, floorDb);
+            vst1q_f32 (dest + i, vreinterpretq_f32_u32 (vandq_u32 (aboveFloor, vreinterpretq_u32_f32 (vmulq_f32 (scale, p)))));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            dest[i] = decibelsToGain (src[i]);
+    }
+
+    //==============================================================================
+    // --- Validación de precisión ---
+    // Barre el rango -100..0 dB comparando contra juce::Decibels (std::log10/std::pow)
+    // con las formas por bloque (las que usa processBlock). Errores en dB.
+    struct AccuracyReport
+    {
+        float maxGainToDecibelsErrorDb = 0.0f;
+        float maxDecibelsToGainErrorDb = 0.0f;
+        int   numPoints = 0;
+    };
+
+    inline AccuracyReport measureAccuracy (float stepDb = 0.001f)
+    {
+        AccuracyReport report;
+
+        constexpr int kChunk = 256;
+        float decibels[kChunk], gains[kChunk], fast[kChunk];
+
+        for (float start = kMinusInfinityDb; start <= 0.0f; start += stepDb * kChunk)
+        {
+            int n = 0;
+            for (; n < kChunk && start + stepDb * (float) n <= 0.0f; ++n)
+            {
+                decibels[n] = start + stepDb * (float) n;
+                gains[n] = juce::Decibels::decibelsToGain (decibels[n], kMinusInfinityDb - 1.0f);
+            }
+
+            gainToDecibels (fast, gains, n);
+
+            for (int i = 0; i < n; ++i)
+            {
+                const float exact = juce::Decibels::gainToDecibels (gains[i], kMinusInfinityDb);
+                report.maxGainToDecibelsErrorDb = juce::jmax (report.maxGainToDecibelsErrorDb,
+                                                              std::abs (fast[i] - exact));
+            }
+
+            decibelsToGain (fast, decibels, n);
+
+            for (int i = 0; i < n; ++i)
+            {
+                if (decibels[i] <= kMinusInfinityDb)
+                    continue;
+
+                const float exact = juce::Decibels::decibelsToGain (decibels[i], kMinusInfinityDb);
+                report.maxDecibelsToGainErrorDb = juce::jmax (report.maxDecibelsToGainErrorDb,
+                                                              std::abs (20.0f * std::log10 (fast[i] / exact)));
+            }
+
+            report.numPoints += n;
+        }
+
+        return report;
+    }
+}
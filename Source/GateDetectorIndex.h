@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+
+    GateDetectorIndex.h
+
+    Índice de detección por fichero para re-renderizados offline
+    (SilentRoomBatch --index). La etapa cara de la puerta (detección: filtro
+    de key, true peak, RMS, ventana de lookahead y log10) no depende de
+    THRESHOLD, RATIO, ATTACK, RELEASE, HOLD, HYSTERESIS, KNEE ni RANGE: se
+    calcula una vez, se guarda y los re-renderizados solo ejecutan el gain
+    computer, el hold y la balística.
+
+    Formato (little-endian nativo, pensado para proyectarse en memoria):
+      - Header (80 bytes): claves del fichero fuente y de los parámetros de
+        detección, latencia, suelo de ruido y el registro del último render.
+      - Un Block por cada 64 muestras (las de los sub-bloques de GateEngine):
+        nivel lineal mínimo y máximo exactos, que deciden las rutas rápidas
+        sin leer nada más, y el nivel de cada muestra en dB como int16
+        (1/256 dB, de -128 a +128 dB). 136 bytes por bloque, ~2.1 bytes por
+        muestra: la mitad que un float y ya sin log10.
+
+    El nivel se cuantifica a ±0.002 dB; con cualquier ratio la diferencia de
+    ganancia frente a un render completo queda por debajo de 0.03 %.
+
+    Un índice vale mientras coincidan las claves (fichero, frecuencia de
+    muestreo, canales, detector, filtro de key, ventana RMS, lookahead y
+    kernels dB). Si no, se reconstruye entero.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstddef>
+#include "GateEngine.h"
+
+namespace GateDetectorIndex
+{
+    static constexpr juce::uint32 indexMagic   = 0x78645253;   // "SRdx"
+    static constexpr int          indexVersion = 1;
+
+    static constexpr int   blockSize     = 64;                 // = GateEngine::fastPathBlockSize
+    static constexpr float dbScale       = 256.0f;             // pasos de int16 por dB
+    static constexpr float dbPerStep     = 1.0f / dbScale;
+
+    //==============================================================================
+    struct Header
+    {
+        juce::uint32 magic   = indexMagic;
+        juce::int32  version = indexVersion;
+        juce::int32  numChannels    = 0;
+        juce::int32  latencySamples = 0;     // lookahead: niveles de más al final
+        double sampleRate = 0.0;
+        juce::int64 sourceLength = 0;        // muestras del fichero
+        juce::int64 numLevels    = 0;        // sourceLength + latencySamples
+        juce::uint64 sourceKey   = 0;        // ruta, tamaño y fecha del fichero
+        juce::uint64 detectorKey = 0;        // parámetros que afectan a la detección
+        float noiseFloorDb = 0.0f;           // NoiseFloorAnalyser sobre el fichero
+        juce::int32 hasNoiseFloor = 0;
+        juce::uint64 renderKey  = 0;         // último render (0 = ninguno)
+        juce::int64  outputTime = 0;         // fecha de la salida de ese render (ms)
+
+        // Mismo fichero y misma detección (no mira el registro del render)
+        bool matches (const Header& other) const noexcept
+        {
+            return magic == other.magic && version == other.version
+                && numChannels == other.numChannels && latencySamples == other.latencySamples
+                && sampleRate == other.sampleRate && sourceLength == other.sourceLength
+                && numLevels == other.numLevels && sourceKey == other.sourceKey
+                && detectorKey == other.detectorKey;
+        }
+    };
+
+    struct Block
+    {
+        float minLevel = 0.0f;               // nivel lineal mínimo del bloque (exacto)
+        float maxLevel = 0.0f;               // nivel lineal máximo del bloque (exacto)
+        juce::int16 levelsDb[blockSize] {};  // nivel de cada muestra en 1/256 dB
+    };
+
+    static_assert (sizeof (Header) == 80, "GateDetectorIndex: la cabecera es parte del formato");
+    static_assert (sizeof (Block) == 8 + 2 * blockSize, "GateDetectorIndex: el bloque es parte del formato");
+
+    inline juce::int64 getNumBlocks (juce::int64 numLevels) noexcept   { return (numLevels + blockSize - 1) / blockSize; }
+
+    //==============================================================================
+    // Escribe un índice nuevo en un temporario; finish() lo pone en su sitio,
+    // así que un índice a medias nunca sustituye a uno válido.
+    class Writer
+    {
+    public:
+        Writer (const juce::File& indexFile, const Header& newHeader, bool useFastMath)
+            : temporary (indexFile), header (newHeader)
+        {
+            header.renderKey  = 0;
+            header.outputTime = 0;
+
+            indexFile.getParentDirectory().createDirectory();
+            converter.setFastMathEnabled (useFastMath);
+
+            stream = std::make_unique<juce::FileOutputStream> (temporary.getFile());
+
+            if (! stream->openedOk() || ! stream->write (&header, sizeof (header)))
+                stream.reset();
+        }
+
+        bool isOpen() const noexcept   { return stream != nullptr; }
+
+        // Suelo de ruido del fichero (se guarda en la cabecera al terminar)
+        void setNoiseFloor (float noiseFloorDb) noexcept
+        {
+            header.noiseFloorDb  = noiseFloorDb;
+            header.hasNoiseFloor = 1;
+        }
+
+        // Niveles lineales de la etapa 1 (GateEngine::detect), en orden
+        bool write (const float* levels, int numSamples)
+        {
+            for (int start = 0; start < numSamples && stream != nullptr;)
+            {
+                const int n = juce::jmin (numSamples - start, blockSize - pendingCount);
+                juce::FloatVectorOperations::copy (pending + pendingCount, levels + start, n);
+
+                start        += n;
+                pendingCount += n;
+
+                if (pendingCount == blockSize && ! flushBlock())
+                    stream.reset();
+            }
+
+            return stream != nullptr;
+        }
+
+        // Completa el último bloque, reescribe la cabecera y sustituye el índice
+        bool finish()
+        {
+            if (stream == nullptr || (pendingCount > 0 && ! flushBlock()) || numWritten != header.numLevels)
+                return false;
+
+            if (! stream->setPosition (0) || ! stream->write (&header, sizeof (header)))
+                return false;
+
+            stream->flush();
+            const bool ok = stream->getStatus().wasOk();
+            stream.reset();
+
+            return ok && temporary.overwriteTargetFileWithTemporary();
+        }
+
+    private:
+        bool flushBlock()
+        {
+            Block block;
+            const auto range = juce::FloatVectorOperations::findMinAndMax (pending, pendingCount);
+            block.minLevel = range.getStart();
+            block.maxLevel = range.getEnd();
+
+            // Mismo suelo y mismo kernel de dB que GateGainComputer en el render
+            converter.levelToDecibels (pending, pendingCount);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float db = i < pendingCount ? pending[i] : GateGainComputer<float>::minusInfinityDb();
+                block.levelsDb[i] = (juce::int16) juce::jlimit (-32768, 32767, juce::roundToInt (db * dbScale));
+            }
+
+            numWritten  += pendingCount;
+            pendingCount = 0;
+
+            return stream->write (&block, sizeof (block));
+        }
+
+        juce::TemporaryFile temporary;
+        std::unique_ptr<juce::FileOutputStream> stream;
+        Header header;
+        GateGainComputer<float> converter;
+
+        float pending[blockSize] {};
+        int pendingCount = 0;
+        juce::int64 numWritten = 0;
+    };
+
+    //==============================================================================
+    // Índice proyectado en memoria (solo lectura). Sin copias: los bloques se
+    // leen directamente de las páginas del fichero.
+    class Reader
+    {
+    public:
+        explicit Reader (const juce::File& indexFile)
+        {
+            if (! indexFile.existsAsFile())
+                return;
+
+            mapped = std::make_unique<juce::MemoryMappedFile> (indexFile, juce::MemoryMappedFile::readOnly);
+
+            if (mapped->getData() == nullptr || mapped->getSize() < sizeof (Header))
+                return;
+
+            std::memcpy (&header, mapped->getData(), sizeof (Header));
+            numBlocks = GateDetectorIndex::getNumBlocks (header.numLevels);
+
+            valid = header.magic == indexMagic && header.version == indexVersion
+                 && header.numLevels >= 0
+                 && mapped->getSize() == sizeof (Header) + (size_t) numBlocks * sizeof (Block);
+
+            if (valid)
+                blocks = reinterpret_cast<const Block*> (static_cast<const char*> (mapped->getData()) + sizeof (Header));
+        }
+
+        bool isValid() const noexcept              { return valid; }
+        const Header& getHeader() const noexcept   { return header; }
+        const Block* getBlocks() const noexcept    { return blocks; }
+        juce::int64 getNumBlocks() const noexcept  { return numBlocks; }
+
+    private:
+        std::unique_ptr<juce::MemoryMappedFile> mapped;
+        Header header;
+        const Block* blocks = nullptr;
+        juce::int64 numBlocks = 0;
+        bool valid = false;
+    };
+
+    // Anota en la cabecera el último render (clave de sus parámetros y fecha
+    // de la salida): si nada cambia, el siguiente lote se salta el fichero.
+    // El índice no debe estar proyectado mientras tanto.
+    inline bool writeRenderRecord (const juce::File& indexFile, juce::uint64 renderKey, juce::int64 outputTime)
+    {
+        juce::FileOutputStream stream (indexFile);
+
+        if (! stream.openedOk() || ! stream.setPosition ((juce::int64) offsetof (Header, renderKey)))
+            return false;
+
+        stream.write (&renderKey, sizeof (renderKey));
+        stream.write (&outputTime, sizeof (outputTime));
+        stream.flush();
+
+        return stream.getStatus().wasOk();
+    }
+
+    //==============================================================================
+    // Etapas 2-5 de GateEngine contra el índice: dB -> gain computer ->
+    // hold/histéresis y balística -> ganancia lineal, con las mismas rutas rápidas por bloque
+    // (decididas con el mínimo y el máximo exactos, sin leer las muestras).
+    class Renderer
+    {
+    public:
+        // Con parámetros fijos: el primer setParameters tras prepare no hace rampa
+        void prepare (const Reader& newIndex, const GateParameters& params, bool useFastMath) noexcept
+        {
+            index = &newIndex;
+            gainComputer.prepare (index->getHeader().sampleRate);
+            gainComputer.setParameters (params);
+            gainComputer.setFastMathEnabled (useFastMath);
+
+            envelope = 0.0f;
+            holdRemaining = 0;
+            position = 0;
+            currentBlock = -1;
+            pathCounts = {};
+            juce::FloatVectorOperations::fill (blockGains, 1.0f, blockSize);
+        }
+
+        // Siguientes numSamples ganancias lineales (1 = puerta abierta).
+        // Pasado el final del índice, la última ganancia se mantiene.
+        void renderGains (float* gains, int numSamples) noexcept
+        {
+            const auto numLevels = index->getHeader().numLevels;
+
+            for (int done = 0; done < numSamples;)
+            {
+                const auto block = position / blockSize;
+
+                if (block != currentBlock && position < numLevels)
+                {
+                    computeBlock (block, (int) juce::jmin ((juce::int64) blockSize, numLevels - block * blockSize));
+                    currentBlock = block;
+                }
+
+                const int offset = (int) (position - currentBlock * blockSize);
+                const int n = position < numLevels ? juce::jmin (numSamples - done, blockSize - offset) : numSamples - done;
+
+                if (position < numLevels)
+                    juce::FloatVectorOperations::copy (gains + done, blockGains + offset, n);
+                else
+                    juce::FloatVectorOperations::fill (gains + done, blockGains[blockSize - 1], n);
+
+                done     += n;
+                position += n;
+            }
+        }
+
+        const GatePathCounts& getPathCounts() const noexcept   { return pathCounts; }
+
+    private:
+        void computeBlock (juce::int64 blockIndex, int numValid) noexcept
+        {
+            const auto& block = index->getBlocks()[blockIndex];
+
+            if (gainComputer.isSettledOpen (envelope, block.minLevel, holdRemaining))
+            {
+                envelope = 0.0f;
+                holdRemaining = gainComputer.getHoldReloadSamples();
+                juce::FloatVectorOperations::fill (blockGains, 1.0f, blockSize);
+                ++pathCounts.open;
+                return;
+            }
+
+            if (gainComputer.isSettledClosed (envelope, block.maxLevel, holdRemaining))
+            {
+                envelope = gainComputer.getClosedTargetDb();
+                juce::FloatVectorOperations::fill (blockGains, gainComputer.getClosedGain(), blockSize);
+                ++pathCounts.closed;
+                return;
+            }
+
+            ++pathCounts.full;
+
+            for (int i = 0; i < numValid; ++i)
+                levelDb[i] = (float) block.levelsDb[i] * dbPerStep;
+
+            gainComputer.computeTargetGainFromDecibels (levelDb, numValid, nullptr, nullptr);
+            gainComputer.applyBallistics (levelDb, numValid, envelope, holdRemaining);
+            gainComputer.decibelsToGain (blockGains, levelDb, numValid);
+
+            // Relleno de un bloque final incompleto (no se usa como ganancia real)
+            if (numValid < blockSize)
+                juce::FloatVectorOperations::fill (blockGains + numValid, blockGains[numValid - 1], blockSize - numValid);
+        }
+
+        const Reader* index = nullptr;
+        GateGainComputer<float> gainComputer;
+        float envelope = 0.0f;
+        int holdRemaining = 0;
+        juce::int64 position = 0;
+        juce::int64 currentBlock = -1;
+        GatePathCounts pathCounts;
+
+        float levelDb[blockSize] {};
+        float blockGains[blockSize] {};
+    };
+}
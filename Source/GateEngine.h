@@ -0,0 +1,1016 @@
+/*
+  ==============================================================================
+
+    GateEngine.h
+
+    Núcleo DSP de la puerta de ruido, independiente de juce::AudioProcessor.
+    Plantilla sobre el tipo de muestra (float/double) y el número de canales:
+    mono y estéreo son especializaciones en tiempo de compilación, así que el
+    bucle interno no comprueba si existe el canal derecho.
+
+    GateGainComputer agrupa lo que no depende de los canales (rampas de
+    parámetros, curva estática con rodilla y rango, balística, hold e
+    histéresis, umbrales de las rutas rápidas y conversiones dB <-> lineal)
+    para que otros motores (multicanal) usen las mismas fórmulas.
+
+    La detección puede hacerse sobre una señal externa (sidechain) y pasar
+    por KeyFilter; sin key ni filtro, la ruta es exactamente la de siempre.
+
+    Sin reservas de memoria fuera de prepare() y sin llamadas virtuales.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <type_traits>
+#include "FastMath.h"
+#include "Lookahead.h"
+#include "KeyFilter.h"
+#include "LevelDetector.h"
+
+//==============================================================================
+// Parámetros de usuario (mismas unidades y valores por defecto que el APVTS)
+struct GateParameters
+{
+    float thresholdDb = -60.0f;  // dB
+    float ratio       = 1.0f;    // N:1
+    float attackMs    = 10.0f;   // ms
+    float releaseMs   = 100.0f;  // ms
+    float lookaheadMs = 0.0f;    // ms (0 = sin lookahead)
+
+    KeyFilterMode keyFilter = KeyFilterMode::off;  // filtro de la señal de detección
+    float keyFrequencyHz    = 1000.0f;             // Hz (corte o centro)
+
+    DetectorMode detector   = DetectorMode::peak;  // peak, RMS o true peak
+    float rmsWindowMs       = 10.0f;               // ms (solo en modo RMS)
+
+    float holdMs       = 0.0f;   // ms abierta tras caer por debajo del umbral de cierre
+    float hysteresisDb = 0.0f;   // dB: abre en threshold, cierra en threshold - hysteresis
+
+    float kneeDb  = 0.0f;        // dB: ancho de la rodilla centrada en el umbral (0 = dura)
+    float rangeDb = 100.0f;      // dB: atenuación máxima (100 = hasta el suelo de -100 dB)
+};
+
+// Contadores de sub-bloques por ruta (para medir la tasa de acierto)
+struct GatePathCounts
+{
+    juce::uint64 open = 0, closed = 0, full = 0;
+};
+
+//==============================================================================
+template <typename SampleType>
+class GateGainComputer
+{
+public:
+    static_assert (std::is_floating_point<SampleType>::value, "GateGainComputer: SampleType debe ser float o double");
+
+    // Envolvente por encima de este valor (dB) se considera puerta abierta:
+    // omitir la ganancia supone un error <= 1.2e-5 (~ -98 dB)
+    static constexpr double settledOpenDb = -1.0e-4;
+
+    // Envolvente a menos de esto (dB) de la GR de puerta cerrada se considera
+    // asentada: desviación de ganancia <= 0.6 % (en -100 dB, <= ~1e-5 absoluto)
+    static constexpr double settledClosedDb = 0.05;
+
+    // Duración de la rampa lineal de THRESHOLD/RATIO (automatización sin zipper)
+    static constexpr double parameterRampSeconds = 0.02;
+
+    // Umbral mínimo de nivel lineal para evitar log10(0) (~-200 dB)
+    static constexpr SampleType minLinearLevel() noexcept   { return SampleType (1.0e-10); }
+
+    // Suelo de la conversión dB <-> lineal (igual que juce::Decibels)
+    static constexpr SampleType minusInfinityDb() noexcept  { return SampleType (-100); }
+
+    // Suelo absoluto de la GR: por debajo de -100 dB la ganancia ya es 0, así
+    // que la envolvente nunca baja de aquí. RANGE sube el suelo (getRangeFloorDb).
+    static constexpr SampleType maxReductionDb() noexcept   { return minusInfinityDb(); }
+
+    //==============================================================================
+    // Invalida la caché de coeficientes; el siguiente setParameters salta sin rampa
+    void prepare (double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+
+        thresholdSmoother.reset (sampleRate, parameterRampSeconds);
+        slopeSmoother.reset (sampleRate, parameterRampSeconds);
+        parametersInitialised = false;
+        cachedThreshold = SampleType (1);
+        cachedSlope     = SampleType (-1);
+        cachedAttackMs  = -1.0f;
+        cachedReleaseMs = -1.0f;
+        cachedHoldMs    = -1.0f;
+        cachedKnee      = SampleType (-1);
+    }
+
+    // Termina cualquier rampa en curso (salta al valor objetivo)
+    void reset() noexcept
+    {
+        thresholdSmoother.setCurrentAndTargetValue (thresholdSmoother.getTargetValue());
+        slopeSmoother.setCurrentAndTargetValue (slopeSmoother.getTargetValue());
+    }
+
+    // Actualiza los coeficientes a partir de los parámetros de usuario.
+    // Pensado para llamarse en cada bloque: solo hace trabajo si algo cambió.
+    void setParameters (const GateParameters& params) noexcept
+    {
+        // THRESHOLD y RATIO: rampa lineal por muestra hacia el nuevo valor.
+        // RATIO se suaviza en el dominio de la pendiente (1 - 1/ratio), que es
+        // lo que usa el gain computer, para no dividir en cada muestra.
+        const auto newThreshold = static_cast<SampleType> (params.thresholdDb);
+        const auto newSlope     = SampleType (1) - (SampleType (1) / static_cast<SampleType> (params.ratio));
+        const auto newHysteresis = juce::jmax (SampleType (0), static_cast<SampleType> (params.hysteresisDb));
+
+        // KNEE y RANGE cambian la forma de la curva al instante (sin rampa):
+        // la balística ya suaviza el salto de la GR objetivo
+        const auto newKnee  = juce::jmax (SampleType (0), static_cast<SampleType> (params.kneeDb));
+        const auto newFloor = juce::jlimit (maxReductionDb(), SampleType (0), -static_cast<SampleType> (params.rangeDb));
+
+        if (parametersInitialised)
+        {
+            thresholdSmoother.setTargetValue (newThreshold);
+            slopeSmoother.setTargetValue (newSlope);
+        }
+        else
+        {
+            thresholdSmoother.setCurrentAndTargetValue (newThreshold);
+            slopeSmoother.setCurrentAndTargetValue (newSlope);
+            parametersInitialised = true;
+        }
+
+        // Umbrales lineales de las rutas rápidas (comparar niveles sin log10)
+        if (newThreshold != cachedThreshold || newSlope != cachedSlope || newHysteresis != cachedHysteresis
+            || newKnee != cachedKnee || newFloor != rangeFloorDb)
+        {
+            cachedThreshold  = newThreshold;
+            cachedSlope      = newSlope;
+            cachedHysteresis = newHysteresis;
+            cachedKnee       = newKnee;
+
+            // Coeficientes de la curva (ver evaluateCurve)
+            kneeDb       = newKnee;
+            halfKneeDb   = newKnee * SampleType (0.5);
+            kneeFactor   = newKnee > SampleType (0) ? SampleType (1) / (SampleType (2) * newKnee) : SampleType (0);
+            rangeFloorDb = newFloor;
+
+            // La GR objetivo es 0 desde el final de la rodilla
+            const SampleType kneeTopDb = newThreshold + halfKneeDb;
+
+            // Histéresis: abierta, la puerta solo cierra por debajo de
+            // kneeTop - hysteresis (threshold - hysteresis con rodilla dura), o
+            // donde la curva toca RANGE si está más arriba. Durante una rampa
+            // de THRESHOLD/RATIO se usa ya la curva final.
+            if (newSlope > SampleType (0) && newHysteresis > SampleType (0))
+            {
+                closeTargetDb    = evaluateCurve (kneeTopDb - newHysteresis, newThreshold, newSlope);
+                closeLevelLinear = juce::Decibels::decibelsToGain (juce::jmax (kneeTopDb - newHysteresis,
+                                                                               levelForReduction (newFloor, newThreshold, newSlope)),
+                                                                   SampleType (-1000));
+            }
+            else
+            {
+                // Ratio 1:1: abierta con cualquier nivel, también con ceros
+                // exactos (silencio digital, PCM entero a bajo nivel)
+                closeTargetDb    = SampleType (0);
+                closeLevelLinear = newSlope > SampleType (0) ? juce::Decibels::decibelsToGain (kneeTopDb, SampleType (-1000))
+                                                             : SampleType (-1);
+            }
+
+            // Abierta: todo el sub-bloque por encima del final de la rodilla
+            // -> targetGR = 0. Con ratio 1:1 la GR objetivo es 0 con cualquier nivel.
+            openLevelLinear = newSlope > SampleType (0) ? juce::Decibels::decibelsToGain (kneeTopDb, SampleType (-1000))
+                                                        : SampleType (0);
+
+            // Cerrada: GR objetivo constante, la de cualquier nivel en el suelo de
+            // la conversión a dB (-100 dB), limitada por RANGE. Todo el
+            // sub-bloque la produce si el nivel no supera el mayor de -100 dB
+            // y el nivel en que la curva toca RANGE.
+            if (newSlope > SampleType (0))
+            {
+                closedTargetDb = evaluateCurve (minusInfinityDb(), newThreshold, newSlope);
+                closedLevelLinear = juce::jmax (juce::Decibels::decibelsToGain (minusInfinityDb(), SampleType (-1000)),
+                                                juce::Decibels::decibelsToGain (levelForReduction (newFloor, newThreshold, newSlope),
+                                                                                SampleType (-1000)));
+                closedGain = juce::Decibels::decibelsToGain (closedTargetDb, minusInfinityDb());
+            }
+            else
+            {
+                closedTargetDb    = SampleType (0);
+                closedLevelLinear = SampleType (-1);   // ratio 1:1: la puerta nunca cierra
+                closedGain        = SampleType (1);
+            }
+        }
+
+        // Balística: std::exp solo cuando cambian ATTACK/RELEASE o la frecuencia
+        // de muestreo (prepare invalida la caché)
+        if (params.attackMs != cachedAttackMs)
+        {
+            cachedAttackMs = params.attackMs;
+            alphaAttack = std::exp (SampleType (-1) / static_cast<SampleType> (params.attackMs * 0.001 * sampleRate));
+        }
+
+        if (params.releaseMs != cachedReleaseMs)
+        {
+            cachedReleaseMs = params.releaseMs;
+            alphaRelease = std::exp (SampleType (-1) / static_cast<SampleType> (params.releaseMs * 0.001 * sampleRate));
+        }
+
+        // Hold en muestras enteras: al abrir (o seguir abierta) el contador se
+        // recarga con holdSamples + 1 y cuenta hacia atrás bajo el umbral de cierre
+        if (params.holdMs != cachedHoldMs)
+        {
+            cachedHoldMs = params.holdMs;
+            holdReload   = juce::roundToInt (juce::jmax (0.0, params.holdMs * 0.001 * sampleRate)) + 1;
+        }
+    }
+
+    // Kernels dB <-> lineal aproximados (FastMath.h). Solo aplica a float.
+    void setFastMathEnabled (bool shouldUseFastMath) noexcept  { fastMath = shouldUseFastMath; }
+
+    bool isSmoothing() const noexcept
+    {
+        return thresholdSmoother.isSmoothing() || slopeSmoother.isSmoothing();
+    }
+
+    // Ratio 1:1 ya alcanzado (sin rampa pendiente): GR objetivo 0 con cualquier nivel
+    bool isUnity() const noexcept
+    {
+        return ! isSmoothing() && slopeSmoother.getTargetValue() <= SampleType (0);
+    }
+
+    // Hold o histéresis activos (si no, applyHold no cambia nada)
+    bool hasHold() const noexcept   { return holdReload > 1 || closeTargetDb < SampleType (0); }
+
+    // Valor del contador de hold tras una muestra con la puerta abierta
+    int getHoldReloadSamples() const noexcept   { return holdReload; }
+
+    // Suelo de la GR con RANGE (dB, entre maxReductionDb() y 0)
+    SampleType getRangeFloorDb() const noexcept   { return rangeFloorDb; }
+
+    //==============================================================================
+    // --- Rutas rápidas (solo válidas con isSmoothing() == false) ---
+    // Abierta: envolvente en 0 dB y todo el sub-bloque sobre el umbral de
+    // apertura, o sobre el de cierre si la puerta ya está abierta
+    // (holdRemaining > 0). Al terminar, el hold queda recargado.
+    bool isSettledOpen (SampleType envelope, SampleType minLevel, int holdRemaining) const noexcept
+    {
+        return envelope >= SampleType (settledOpenDb)
+            && (holdRemaining > 0 ? minLevel > closeLevelLinear : minLevel >= openLevelLinear);
+    }
+
+    // Cerrada: puerta cerrada (sin hold pendiente), envolvente asentada en la
+    // GR de puerta cerrada y todo el sub-bloque por debajo de su nivel -> una
+    // sola ganancia constante
+    bool isSettledClosed (SampleType envelope, SampleType maxLevel, int holdRemaining) const noexcept
+    {
+        return holdRemaining == 0
+            && std::abs (envelope - closedTargetDb) <= SampleType (settledClosedDb)
+            && maxLevel <= closedLevelLinear;
+    }
+
+    SampleType getClosedTargetDb() const noexcept  { return closedTargetDb; }
+    SampleType getClosedGain() const noexcept      { return closedGain; }
+
+    //==============================================================================
+    // Avanza las rampas numSamples muestras (una sola vez por sub-bloque,
+    // aunque luego se apliquen a varios detectores)
+    void fillRamps (SampleType* thresholdRamp, SampleType* slopeRamp, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            thresholdRamp[i] = thresholdSmoother.getNextValue();
+            slopeRamp[i]     = slopeSmoother.getNextValue();
+        }
+    }
+
+    // Etapas 2 y 3, in situ: nivel lineal detectado -> GR objetivo en dB.
+    // Con rampas (thresholdRamp != nullptr) usa umbral y pendiente por muestra.
+    void computeTargetGain (SampleType* data, int numSamples,
+                            const SampleType* thresholdRamp, const SampleType* slopeRamp) const noexcept
+    {
+        // 2. Protección matemática + conversión a dB (bucle sin ramas)
+        levelToDecibels (data, numSamples);
+
+        computeTargetGainFromDecibels (data, numSamples, thresholdRamp, slopeRamp);
+    }
+
+    // Etapa 2 sola, in situ: nivel lineal -> dB (con el suelo de minusInfinityDb)
+    void levelToDecibels (SampleType* data, int numSamples) const noexcept
+    {
+        juce::FloatVectorOperations::max (data, data, minLinearLevel(), numSamples);
+        gainToDecibels (data, numSamples);
+    }
+
+    // Etapa 3 sola, in situ: nivel en dB (de levelToDecibels) -> GR objetivo
+    void computeTargetGainFromDecibels (SampleType* data, int numSamples,
+                                        const SampleType* thresholdRamp, const SampleType* slopeRamp) const noexcept
+    {
+        // 3'. Rodilla suave: la curva de evaluateCurve en un bucle sin ramas
+        //     (min/max y aritmética) que el compilador vectoriza
+        if (kneeDb > SampleType (0))
+        {
+            computeKneeTargetGain (data, numSamples, thresholdRamp, slopeRamp);
+            return;
+        }
+
+        // 3. Gain Computer vectorizado (rodilla dura):
+        //    targetGR = min (levelDb - threshold, 0) * (1 - 1/ratio)
+        //    equivale a la rama "levelDb < threshold" de la ruta escalar.
+        if (thresholdRamp != nullptr)
+        {
+            // Durante una rampa: umbral y pendiente por muestra
+            juce::FloatVectorOperations::subtract (data, thresholdRamp, numSamples);
+            juce::FloatVectorOperations::min (data, data, SampleType (0), numSamples);
+            juce::FloatVectorOperations::multiply (data, slopeRamp, numSamples);
+        }
+        else
+        {
+            // Estado estable: mismo coste que con parámetros constantes
+            juce::FloatVectorOperations::add (data, -thresholdSmoother.getTargetValue(), numSamples);
+            juce::FloatVectorOperations::min (data, data, SampleType (0), numSamples);
+            juce::FloatVectorOperations::multiply (data, slopeSmoother.getTargetValue(), numSamples);
+        }
+
+        // Profundidad máxima: la GR objetivo no baja del suelo de RANGE
+        juce::FloatVectorOperations::max (data, data, rangeFloorDb, numSamples);
+    }
+
+    // Curva estática: GR objetivo (dB, <= 0) de un nivel en dB. Rodilla
+    // cuadrática de ancho kneeDb centrada en el umbral, sin ramas:
+    //   u = min (nivel - umbral - rodilla/2, 0),  c = max (u, -rodilla)
+    //   GR = (u - c - c^2 / (2 rodilla)) * pendiente
+    // Bajo la rodilla (c = -rodilla) es la recta (nivel - umbral) * pendiente;
+    // dentro, una parábola tangente a la recta y a 0 dB en sus extremos.
+    // Después, el suelo de RANGE.
+    SampleType evaluateCurve (SampleType levelDb, SampleType threshold, SampleType slope) const noexcept
+    {
+        if (kneeDb <= SampleType (0))
+            return juce::jmax (juce::jmin (levelDb - threshold, SampleType (0)) * slope, rangeFloorDb);
+
+        const SampleType u = juce::jmin (levelDb - threshold - halfKneeDb, SampleType (0));
+        const SampleType c = juce::jmax (u, -kneeDb);
+        return juce::jmax ((u - c - c * c * kneeFactor) * slope, rangeFloorDb);
+    }
+
+    // Un paso de la balística Attack/Release (filtro de un polo)
+    //   GATE: Attack = puerta se ABRE (envelope sube hacia 0 dB)
+    //         Release = puerta se CIERRA (envelope baja hacia -N dB)
+    SampleType smooth (SampleType targetGR, SampleType envelope) const noexcept
+    {
+        const SampleType alpha = (targetGR > envelope) ? alphaAttack : alphaRelease;
+        return targetGR + alpha * (envelope - targetGR);
+    }
+
+    // Etapa 3b, una muestra: hold e histéresis sobre la GR objetivo, sin ramas
+    // (máscaras enteras de 0/1). remaining son las muestras que la puerta
+    // sigue abierta (0 = cerrada):
+    //   - GR objetivo 0 (nivel >= final de la rodilla): abre y recarga el hold
+    //   - abierta y GR > closeTargetDb (nivel > umbral de cierre): recarga.
+    //     Estricto: si RANGE recorta closeTargetDb, el suelo no recarga
+    //   - si no, el contador baja hasta 0 y la puerta cierra
+    // Mientras está abierta la GR objetivo es 0. Sin hold ni histéresis
+    // devuelve targetGR tal cual.
+    SampleType applyHold (SampleType targetGR, int& remaining) const noexcept
+    {
+        const int isOpen = remaining > 0;
+        const int reload = -((int) (targetGR >= SampleType (0)) | (isOpen & (int) (targetGR > closeTargetDb)));
+
+        // reload ? holdReload : remaining - isOpen (máscara: todo unos o todo ceros)
+        remaining = (holdReload & reload) | ((remaining - isOpen) & ~reload);
+        return targetGR * static_cast<SampleType> (remaining == 0);
+    }
+
+    // Etapas 3b y 4, in situ: GR objetivo -> envolvente suavizada. Devuelve la GR mínima.
+    // El hold va en el mismo bucle recursivo que la balística: sus operaciones
+    // enteras no dependen de la envolvente y se solapan con la latencia del
+    // filtro de un polo. Sin hold ni histéresis, el bucle es el de siempre.
+    SampleType applyBallistics (SampleType* data, int numSamples, SampleType& envelope, int& holdRemaining) const noexcept
+    {
+        return hasHold() ? applyBallisticsImpl<true>  (data, numSamples, envelope, holdRemaining)
+                         : applyBallisticsImpl<false> (data, numSamples, envelope, holdRemaining);
+    }
+
+    // Etapas 3b y 4 para varios detectores a la vez. frames está entrelazado
+    // [muestra][detector]; el bucle interno recorre los detectores, no tiene
+    // dependencias entre iteraciones y se vectoriza entre canales.
+    void applyBallisticsInterleaved (SampleType* frames, int numSamples, SampleType* detectorEnvelopes,
+                                     int* detectorHolds, int numDetectors) const noexcept
+    {
+        if (hasHold())
+            applyBallisticsInterleavedImpl<true> (frames, numSamples, detectorEnvelopes, detectorHolds, numDetectors);
+        else
+            applyBallisticsInterleavedImpl<false> (frames, numSamples, detectorEnvelopes, detectorHolds, numDetectors);
+    }
+
+    // Umbral y pendiente de la siguiente muestra (avanza las rampas)
+    void getNextThresholdAndSlope (SampleType& threshold, SampleType& slope) noexcept
+    {
+        threshold = thresholdSmoother.getNextValue();
+        slope     = slopeSmoother.getNextValue();
+    }
+
+    // Etapas 2-4 para una muestra (rutas escalares de referencia), con umbral
+    // y pendiente leídos de getNextThresholdAndSlope(). Devuelve la envolvente.
+    SampleType processSampleReference (SampleType peakLevel, SampleType envelope, int& holdRemaining,
+                                       SampleType threshold, SampleType slope) const noexcept
+    {
+        // 2. Protección matemática + conversión a dB
+        peakLevel = std::fmax (peakLevel, minLinearLevel());
+        const SampleType levelDb = juce::Decibels::gainToDecibels (peakLevel, minusInfinityDb());
+
+        // 3. Gain Computer: reducción de ganancia objetivo (en dB, <= 0),
+        //    con rodilla y suelo de RANGE
+        SampleType targetGR = evaluateCurve (levelDb, threshold, slope);
+
+        // 3b. Hold e histéresis
+        targetGR = applyHold (targetGR, holdRemaining);
+
+        // 4. Balística
+        return smooth (targetGR, envelope);
+    }
+
+    //==============================================================================
+    // Conversión in situ de nivel lineal (> 0) a dB
+    void gainToDecibels (SampleType* data, int numSamples) const noexcept
+    {
+        if constexpr (canUseFastMath)
+        {
+            if (fastMath)
+            {
+                FastMath::gainToDecibels (data, data, numSamples);
+                return;
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = juce::jmax (minusInfinityDb(), std::log10 (data[i]) * SampleType (20));
+    }
+
+    void decibelsToGain (SampleType* dest, const SampleType* decibels, int numSamples) const noexcept
+    {
+        if constexpr (canUseFastMath)
+        {
+            if (fastMath)
+            {
+                FastMath::decibelsToGain (dest, decibels, numSamples);
+                return;
+            }
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = decibels[i] > minusInfinityDb() ? std::pow (SampleType (10), decibels[i] * SampleType (0.05))
+                                                      : SampleType (0);
+    }
+
+private:
+    static constexpr bool canUseFastMath = std::is_same<SampleType, float>::value;
+
+    // Inversa de la curva (pendiente > 0): nivel en dB en el que la GR
+    // objetivo, sin el suelo de RANGE, vale reductionDb (<= 0)
+    SampleType levelForReduction (SampleType reductionDb, SampleType threshold, SampleType slope) const noexcept
+    {
+        const SampleType belowThreshold = reductionDb / slope;
+
+        if (kneeDb <= SampleType (0) || belowThreshold <= -halfKneeDb)
+            return threshold + belowThreshold;
+
+        return threshold + halfKneeDb - std::sqrt (SampleType (-2) * kneeDb * reductionDb / slope);
+    }
+
+    // Etapa 3 con rodilla suave (misma fórmula y mismo orden que evaluateCurve)
+    void computeKneeTargetGain (SampleType* data, int numSamples,
+                                const SampleType* thresholdRamp, const SampleType* slopeRamp) const noexcept
+    {
+        const SampleType knee     = kneeDb;
+        const SampleType halfKnee = halfKneeDb;
+        const SampleType factor   = kneeFactor;
+        const SampleType floorDb  = rangeFloorDb;
+
+        if (thresholdRamp != nullptr)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const SampleType u = juce::jmin (data[i] - thresholdRamp[i] - halfKnee, SampleType (0));
+                const SampleType c = juce::jmax (u, -knee);
+                data[i] = juce::jmax ((u - c - c * c * factor) * slopeRamp[i], floorDb);
+            }
+        }
+        else
+        {
+            const SampleType threshold = thresholdSmoother.getTargetValue();
+            const SampleType slope     = slopeSmoother.getTargetValue();
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const SampleType u = juce::jmin (data[i] - threshold - halfKnee, SampleType (0));
+                const SampleType c = juce::jmax (u, -knee);
+                data[i] = juce::jmax ((u - c - c * c * factor) * slope, floorDb);
+            }
+        }
+    }
+
+    template <bool withHold>
+    SampleType applyBallisticsImpl (SampleType* data, int numSamples, SampleType& envelope, int& holdRemaining) const noexcept
+    {
+        SampleType env   = envelope;
+        SampleType maxGR = SampleType (0);
+
+        // Sin hold, el estado es el de la última muestra: abierta si su GR objetivo es 0
+        if (! withHold && numSamples > 0)
+            holdRemaining = data[numSamples - 1] >= SampleType (0) ? holdReload : 0;
+
+        int remaining = holdRemaining;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            env = smooth (withHold ? applyHold (data[i], remaining) : data[i], env);
+            data[i] = env;
+            maxGR = juce::jmin (maxGR, env);
+        }
+
+        envelope = env;
+        holdRemaining = remaining;
+        return maxGR;
+    }
+
+    template <bool withHold>
+    void applyBallisticsInterleavedImpl (SampleType* frames, int numSamples, SampleType* detectorEnvelopes,
+                                         int* detectorHolds, int numDetectors) const noexcept
+    {
+        const SampleType attack  = alphaAttack;
+        const SampleType release = alphaRelease;
+
+        if (! withHold && numSamples > 0)
+            for (int d = 0; d < numDetectors; ++d)
+                detectorHolds[d] = frames[(numSamples - 1) * numDetectors + d] >= SampleType (0) ? holdReload : 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = frames + i * numDetectors;
+
+            for (int d = 0; d < numDetectors; ++d)
+            {
+                const SampleType targetGR = withHold ? applyHold (frame[d], detectorHolds[d]) : frame[d];
+                const SampleType env      = detectorEnvelopes[d];
+                const SampleType alpha    = (targetGR > env) ? attack : release;
+                const SampleType next     = targetGR + alpha * (env - targetGR);
+
+                detectorEnvelopes[d] = next;
+                frame[d] = next;
+            }
+        }
+    }
+
+    double sampleRate = 44100.0;
+
+    // --- Parámetros suavizados (rampa lineal por muestra) ---
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> thresholdSmoother;  // dB
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> slopeSmoother;      // 1 - 1/ratio
+    bool parametersInitialised = false;
+
+    // --- Coeficientes de balística (en caché hasta que cambien) ---
+    SampleType alphaAttack  = SampleType (0);
+    SampleType alphaRelease = SampleType (0);
+    float cachedAttackMs  = -1.0f;
+    float cachedReleaseMs = -1.0f;
+    bool fastMath = false;
+
+    // --- Hold (muestras enteras) e histéresis ---
+    int holdReload = 1;                          // holdSamples + 1
+    float cachedHoldMs = -1.0f;
+    SampleType cachedHysteresis = SampleType (-1);
+    SampleType closeTargetDb    = SampleType (0);  // GR objetivo en threshold - hysteresis
+    SampleType closeLevelLinear = SampleType (0);  // nivel lineal de threshold - hysteresis
+
+    // --- Curva estática: rodilla y suelo de RANGE (en caché hasta que cambien) ---
+    SampleType cachedKnee   = SampleType (-1);
+    SampleType kneeDb       = SampleType (0);
+    SampleType halfKneeDb   = SampleType (0);
+    SampleType kneeFactor   = SampleType (0);                  // 1 / (2 * kneeDb)
+    SampleType rangeFloorDb = GateGainComputer::maxReductionDb();
+
+    // --- Rutas rápidas (umbrales lineales en caché) ---
+    SampleType cachedThreshold   = SampleType (1);
+    SampleType cachedSlope       = SampleType (-1);
+    SampleType openLevelLinear   = SampleType (0);
+    SampleType closedLevelLinear = SampleType (-1);
+    SampleType closedTargetDb    = SampleType (0);
+    SampleType closedGain        = SampleType (1);
+};
+
+//==============================================================================
+template <typename SampleType, int NumChannels>
+class GateEngine
+{
+public:
+    static_assert (std::is_floating_point<SampleType>::value, "GateEngine: SampleType debe ser float o double");
+    static_assert (NumChannels >= 1, "GateEngine: se necesita al menos un canal");
+
+    using GainComputer = GateGainComputer<SampleType>;
+    using PathCounts   = GatePathCounts;
+
+    static constexpr int numChannels = NumChannels;
+
+    // Lookahead máximo: fija el tamaño de la línea de retardo reservada en prepare()
+    static constexpr float maxLookaheadMs = 10.0f;
+
+    // Tamaño de sub-bloque en el que se decide la ruta (abierta / cerrada / completa)
+    static constexpr int fastPathBlockSize = 64;
+
+    static int lookaheadMsToSamples (float lookaheadMs, double sampleRate) noexcept
+    {
+        return juce::roundToInt (juce::jlimit (0.0f, maxLookaheadMs, lookaheadMs) * 0.001 * sampleRate);
+    }
+
+    //==============================================================================
+    // Reserva los buffers de trabajo. Única función que reserva memoria.
+    // Los bloques del host se procesan en sub-bloques de fastPathBlockSize como máximo.
+    void prepare (double newSampleRate, int maximumBlockSize)
+    {
+        sampleRate   = newSampleRate;
+        subBlockSize = juce::jmin (juce::jmax (1, maximumBlockSize), fastPathBlockSize);
+
+        levelBuffer.allocate ((size_t) subBlockSize, true);
+        gainBuffer.allocate  ((size_t) subBlockSize, true);
+        rampBuffer.allocate  ((size_t) subBlockSize, true);
+
+        // Rampas de parámetros y caché de coeficientes (se recalculan en el
+        // primer setParameters tras prepare, que además salta sin rampa)
+        gainComputer.prepare (sampleRate);
+
+        // Lookahead: ventana de detección de L + 1 muestras y retardo de L muestras
+        const int maxLookahead = lookaheadMsToSamples (maxLookaheadMs, sampleRate);
+        peakWindow.prepare (maxLookahead + 1);
+        lookaheadDelay.prepare (maxLookahead, subBlockSize);
+
+        keyFilter.prepare (sampleRate, NumChannels);
+        truePeak.prepare (NumChannels);
+        rms.prepare (RunningRms<SampleType>::windowMsToSamples (RunningRms<SampleType>::maxWindowMs, sampleRate));
+        detectorMode = DetectorMode::peak;
+
+        reset();
+    }
+
+    // Reinicia el estado del seguidor de envolvente (puerta abierta) y del lookahead
+    void reset() noexcept
+    {
+        envelope = SampleType (0);
+        holdRemaining = 0;
+        peakWindow.reset();
+        lookaheadDelay.reset();
+        keyFilter.reset();
+        truePeak.reset();
+        rms.reset();
+        gainComputer.reset();
+    }
+
+    // Actualiza los coeficientes a partir de los parámetros de usuario.
+    // Pensado para llamarse en cada bloque: solo hace trabajo si algo cambió.
+    void setParameters (const GateParameters& params) noexcept
+    {
+        gainComputer.setParameters (params);
+        keyFilter.setParameters (params.keyFilter, params.keyFrequencyHz);
+
+        // Cambiar de detector o de ventana RMS vacía su estado (sin reservar)
+        const int rmsLength = RunningRms<SampleType>::windowMsToSamples (params.rmsWindowMs, sampleRate);
+
+        if (params.detector != detectorMode || rmsLength != rms.getWindowLength())
+        {
+            detectorMode = params.detector;
+            truePeak.reset();
+            rms.setWindowLength (rmsLength);
+        }
+
+        // Cambiar el lookahead solo reajusta índices dentro de lo ya reservado y
+        // conserva el audio retrasado. Sin lookahead el retardo y la ventana no
+        // se alimentan: al activarlo se parte de cero.
+        const int lookahead = lookaheadMsToSamples (params.lookaheadMs, sampleRate);
+
+        if (lookahead != lookaheadDelay.getDelay())
+        {
+            if (lookaheadDelay.getDelay() == 0)
+            {
+                lookaheadDelay.reset();
+                peakWindow.reset();
+            }
+
+            lookaheadDelay.setDelay (lookahead);
+            peakWindow.setWindowLength (lookaheadDelay.getDelay() + 1);
+        }
+    }
+
+    // Latencia añadida por el lookahead (en muestras)
+    int getLatencySamples() const noexcept                     { return lookaheadDelay.getDelay(); }
+
+    // Kernels dB <-> lineal aproximados (FastMath.h). Solo aplica a float.
+    void setFastMathEnabled (bool shouldUseFastMath) noexcept  { gainComputer.setFastMathEnabled (shouldUseFastMath); }
+
+    SampleType getEnvelope() const noexcept                    { return envelope; }
+
+    // Relevo entre motores: continuar desde la GR de otro sin saltos de ganancia
+    void setEnvelope (SampleType newEnvelope) noexcept
+    {
+        envelope = juce::jlimit (GainComputer::maxReductionDb(), SampleType (0), newEnvelope);
+    }
+
+    // Relevo entre motores: copia en dest (NumChannels canales) la entrada que
+    // el lookahead aún retiene y devuelve cuántas muestras por canal son
+    int copyPendingInput (SampleType* const* dest) const noexcept
+    {
+        for (int ch = 0; ch < NumChannels; ++ch)
+            lookaheadDelay.copyPending (ch, dest[ch]);
+
+        return lookaheadDelay.getDelay();
+    }
+
+    // Sub-bloques procesados por cada ruta en la última llamada a process()
+    const PathCounts& getLastPathCounts() const noexcept       { return lastPathCounts; }
+
+    //==============================================================================
+    // Ruta vectorizada por bloques. Procesa in situ los NumChannels canales y
+    // devuelve la GR mínima (más negativa, en dB) del bloque.
+    // keyChannels (opcional, NumChannels punteros de solo lectura, p. ej. al bus
+    // de sidechain del host) sustituye a channels como señal de detección.
+    SampleType process (SampleType* const* channels, int numSamples,
+                        const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        if (levelBuffer == nullptr)
+        {
+            jassertfalse; // process() llamado sin prepare()
+            return processReference (channels, numSamples, keyChannels);
+        }
+
+        SampleType maxGR = SampleType (0);
+        lastPathCounts = {};
+
+        // Sub-bloques del tamaño de los buffers de trabajo: en cada uno se elige
+        // la ruta según el estado de la puerta
+        for (int start = 0; start < numSamples; start += subBlockSize)
+        {
+            const int chunk = juce::jmin (subBlockSize, numSamples - start);
+            maxGR = juce::jmin (maxGR, processChunk (channels, keyChannels, start, chunk));
+        }
+
+        return maxGR;
+    }
+
+    // Solo la detección (etapas 1-1b): escribe en levels el nivel lineal
+    // enlazado de cada muestra, el mismo que usa process() para decidir la
+    // ganancia, sin tocar el audio ni la envolvente. Para índices de detección
+    // offline (GateDetectorIndex.h).
+    void detect (const SampleType* const* channels, int numSamples, SampleType* levels,
+                 const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        for (int start = 0; start < numSamples; start += subBlockSize)
+        {
+            const int chunk = juce::jmin (subBlockSize, numSamples - start);
+            detectChunk (channels, keyChannels, start, chunk);
+            juce::FloatVectorOperations::copy (levels + start, levelBuffer.get(), chunk);
+        }
+    }
+
+    // Ruta escalar de referencia (bucle original muestra a muestra, siempre exacto).
+    SampleType processReference (SampleType* const* channels, int numSamples,
+                                 const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        SampleType maxGR = SampleType (0);
+        const SampleType* const* detector = keyChannels != nullptr ? keyChannels : channels;
+        const bool filterKey = keyFilter.isActive();
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            // 1. Detección de nivel: peak enlazado (máximo de todos los canales),
+            //    sobre la key filtrada si el filtro está activo
+            SampleType peakLevel = SampleType (0);
+
+            for (int ch = 0; ch < NumChannels; ++ch)
+            {
+                const SampleType key   = filterKey ? keyFilter.processSample (ch, detector[ch][sample]) : detector[ch][sample];
+                const SampleType chAbs = detectorMode == DetectorMode::truePeak ? truePeak.processSample (ch, key) : std::abs (key);
+                if (chAbs > peakLevel)
+                    peakLevel = chAbs;
+            }
+
+            if (detectorMode == DetectorMode::rms)
+                peakLevel = rms.push (peakLevel);
+
+            // 1b. Lookahead: máximo de la ventana que termina en la muestra actual
+            const bool useLookahead = lookaheadDelay.getDelay() > 0;
+
+            if (useLookahead)
+                peakLevel = peakWindow.push (peakLevel);
+
+            // 2-4. dB, gain computer con THRESHOLD/RATIO suavizados muestra a
+            //      muestra y balística Attack/Release
+            SampleType threshold, slope;
+            gainComputer.getNextThresholdAndSlope (threshold, slope);
+            envelope = gainComputer.processSampleReference (peakLevel, envelope, holdRemaining, threshold, slope);
+
+            // 5. Convertir GR suavizada de dB a factor lineal
+            const SampleType gainLinear = juce::Decibels::decibelsToGain (envelope, GainComputer::minusInfinityDb());
+
+            // 6. Aplicar ganancia a todos los canales (al audio retrasado si hay lookahead)
+            for (int ch = 0; ch < NumChannels; ++ch)
+            {
+                const SampleType input = channels[ch][sample];
+                channels[ch][sample] = (useLookahead ? lookaheadDelay.processSample (ch, input) : input) * gainLinear;
+            }
+
+            if (useLookahead)
+                lookaheadDelay.advance();
+
+            // 7. Tracking del máximo GR para el medidor GUI
+            if (envelope < maxGR)
+                maxGR = envelope;
+        }
+
+        return maxGR;
+    }
+
+private:
+    // --- RUTA VECTORIZADA ---
+    // Cada etapa recorre el tramo completo, de forma que los bucles sin dependencias
+    // se vectorizan (FloatVectorOperations o autovectorización del compilador; MSVC
+    // vectoriza log10/pow mediante SVML). Solo la balística es recursiva y escalar.
+    //
+    // Tolerancia frente a processReference: con kernels exactos las operaciones son
+    // las mismas y en el mismo orden, por lo que la salida es idéntica salvo redondeo
+    // de la librería matemática vectorial (<= 1e-6 relativo, muy por debajo de -120 dB).
+    // Con FastMath el error de las conversiones es <= ~1e-4 dB (ver FastMath.h).
+    SampleType processChunk (SampleType* const* channels, const SampleType* const* keyChannels,
+                             int offset, int numSamples) noexcept
+    {
+        auto* levelDb    = levelBuffer.get();
+        auto* gainLinear = gainBuffer.get();
+
+        // 1-1b. Nivel detectado en levelBuffer
+        detectChunk (channels, keyChannels, offset, numSamples);
+
+        const bool useLookahead = lookaheadDelay.getDelay() > 0;
+
+        // 1c. Rutas rápidas: con parámetros estables, decidir con el rango de
+        //     niveles lineales si la puerta está asentada (sin log/exp)
+        const bool smoothing = gainComputer.isSmoothing();
+
+        if (! smoothing)
+        {
+            const auto levelRange = juce::FloatVectorOperations::findMinAndMax (levelDb, numSamples);
+
+            if (gainComputer.isSettledOpen (envelope, levelRange.getStart(), holdRemaining))
+            {
+                envelope = SampleType (0);
+                holdRemaining = gainComputer.getHoldReloadSamples();
+
+                if (useLookahead)
+                    lookaheadDelay.process (channels, offset, numSamples);
+
+                ++lastPathCounts.open;
+                return SampleType (0);
+            }
+
+            if (gainComputer.isSettledClosed (envelope, levelRange.getEnd(), holdRemaining))
+            {
+                envelope = gainComputer.getClosedTargetDb();
+
+                if (useLookahead)
+                    lookaheadDelay.process (channels, offset, numSamples);
+
+                const SampleType closedGain = gainComputer.getClosedGain();
+
+                for (int ch = 0; ch < NumChannels; ++ch)
+                {
+                    if (closedGain > SampleType (0))
+                        juce::FloatVectorOperations::multiply (channels[ch] + offset, closedGain, numSamples);
+                    else
+                        juce::FloatVectorOperations::clear (channels[ch] + offset, numSamples);
+                }
+
+                ++lastPathCounts.closed;
+                return envelope;
+            }
+        }
+
+        ++lastPathCounts.full;
+
+        // 2-3. dB y gain computer (durante una rampa, umbral y pendiente por muestra)
+        if (smoothing)
+        {
+            gainComputer.fillRamps (gainLinear, rampBuffer.get(), numSamples);
+            gainComputer.computeTargetGain (levelDb, numSamples, gainLinear, rampBuffer.get());
+        }
+        else
+        {
+            gainComputer.computeTargetGain (levelDb, numSamples, nullptr, nullptr);
+        }
+
+        // 3b-4. Hold/histéresis y balística Attack/Release (filtro de un polo, recursivo)
+        //      El resultado sobrescribe la GR objetivo con la envolvente suavizada.
+        const SampleType maxGR = gainComputer.applyBallistics (levelDb, numSamples, envelope, holdRemaining);
+
+        // 5. Convertir GR suavizada de dB a factor lineal (bucle sin ramas)
+        gainComputer.decibelsToGain (gainLinear, levelDb, numSamples);
+
+        // 6. Retrasar el audio L muestras y aplicar la ganancia (multiplicación vectorial)
+        if (useLookahead)
+            lookaheadDelay.process (channels, offset, numSamples);
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+            juce::FloatVectorOperations::multiply (channels[ch] + offset, gainLinear, numSamples);
+
+        return maxGR;
+    }
+
+    // Etapa 1 completa: nivel lineal enlazado de numSamples muestras en levelBuffer
+    void detectChunk (const SampleType* const* channels, const SampleType* const* keyChannels,
+                      int offset, int numSamples) noexcept
+    {
+        auto* levelDb    = levelBuffer.get();
+        auto* gainLinear = gainBuffer.get();
+
+        // 1. Detección de nivel: peak enlazado (|x| de cada canal y máximo)
+        if (keyChannels == nullptr && ! keyFilter.isActive() && detectorMode != DetectorMode::truePeak)
+        {
+            juce::FloatVectorOperations::abs (levelDb, channels[0] + offset, numSamples);
+
+            for (int ch = 1; ch < NumChannels; ++ch)
+            {
+                juce::FloatVectorOperations::abs (gainLinear, channels[ch] + offset, numSamples);
+                juce::FloatVectorOperations::max (levelDb, levelDb, gainLinear, numSamples);
+            }
+        }
+        else
+        {
+            detectLevel (keyChannels != nullptr ? keyChannels : channels, offset, numSamples);
+        }
+
+        // 1a. RMS deslizante sobre el nivel enlazado (O(1) por muestra)
+        if (detectorMode == DetectorMode::rms)
+            rms.process (levelDb, numSamples);
+
+        // 1b. Lookahead: máximo deslizante O(1) sobre L + 1 muestras
+        if (lookaheadDelay.getDelay() > 0)
+            peakWindow.process (levelDb, numSamples);
+    }
+
+    // 1 con sidechain, filtro de key o true peak: nivel rectificado de cada canal
+    // y máximo. Un sidechain mono llega repetido en todos los canales: se
+    // detecta una vez.
+    void detectLevel (const SampleType* const* key, int offset, int numSamples) noexcept
+    {
+        auto* levelDb    = levelBuffer.get();
+        auto* gainLinear = gainBuffer.get();
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            if (ch > 0 && key[ch] == key[ch - 1])
+                continue;
+
+            auto* destination = ch == 0 ? levelDb : gainLinear;
+            const SampleType* source = key[ch] + offset;
+
+            if (keyFilter.isActive())
+            {
+                keyFilter.process (ch, source, destination, numSamples);
+                source = destination;
+            }
+
+            if (detectorMode == DetectorMode::truePeak)
+                truePeak.process (ch, source, destination, numSamples);
+            else
+                juce::FloatVectorOperations::abs (destination, source, numSamples);
+
+            if (ch > 0)
+                juce::FloatVectorOperations::max (levelDb, levelDb, gainLinear, numSamples);
+        }
+    }
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    int subBlockSize  = 0;
+
+    // --- Gain computer, balística y umbrales de las rutas rápidas ---
+    GainComputer gainComputer;
+    PathCounts lastPathCounts;
+
+    // --- Estado del Seguidor de Envolvente ---
+    SampleType envelope = SampleType (0);  // GR suavizada (en dB, valor <= 0)
+    int holdRemaining   = 0;               // muestras que la puerta sigue abierta (0 = cerrada)
+
+    // --- Buffers de trabajo (reservados en prepare) ---
+    juce::HeapBlock<SampleType> levelBuffer;  // nivel detectado / GR objetivo (dB)
+    juce::HeapBlock<SampleType> gainBuffer;   // ganancia lineal / rampa de umbral
+    juce::HeapBlock<SampleType> rampBuffer;   // rampa de pendiente
+
+    // --- Lookahead ---
+    SlidingWindowMax<SampleType> peakWindow;
+    LookaheadDelay<SampleType, NumChannels> lookaheadDelay;
+
+    // --- Filtro de la señal de detección (un estado por canal) ---
+    KeyFilter<SampleType> keyFilter;
+
+    // --- Modo del detector ---
+    DetectorMode detectorMode = DetectorMode::peak;
+    TruePeakDetector<SampleType> truePeak;   // un estado por canal
+    RunningRms<SampleType> rms;              // sobre el nivel enlazado
+};
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    GateTelemetry.h
+
+    Telemetría del audio thread hacia la GUI: un registro de tamaño fijo por
+    bloque (GR mínima y máxima, pico de entrada y de salida, estado de la
+    puerta) en un FIFO de un productor y un consumidor.
+
+    juce::AbstractFifo sobre un array preasignado: escribir y leer son unas
+    pocas cargas/almacenamientos atómicos, sin bloqueos ni reservas (wait-free
+    en ambos lados). Si el FIFO está lleno (editor cerrado o GUI parada) el
+    registro se descarta y se cuenta; el audio thread nunca espera.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Estado de la puerta en un bloque (según las rutas de los sub-bloques)
+enum class GateState : juce::uint8
+{
+    open = 0,   // todo el bloque asentado abierto
+    moving,     // abriendo, cerrando o con puerta parcial
+    closed      // todo el bloque asentado cerrado
+};
+
+struct GateTelemetryRecord
+{
+    float minGainReductionDb = 0.0f;   // GR más profunda del bloque (dB, <= 0)
+    float maxGainReductionDb = 0.0f;   // GR menos profunda del bloque (dB, <= 0)
+    float inputPeak  = 0.0f;           // pico lineal del bus principal antes de la puerta
+    float outputPeak = 0.0f;           // pico lineal después de la puerta
+    juce::uint32 numSamples = 0;
+    GateState state = GateState::open;
+};
+
+//==============================================================================
+class GateTelemetryFifo
+{
+public:
+    // ~1 s de bloques de 32 muestras a 96 kHz; 20 bytes por registro
+    static constexpr int capacity = 4096;
+
+    GateTelemetryFifo() = default;
+
+    //==============================================================================
+    // Audio thread: añade un registro. Devuelve false si el FIFO está lleno.
+    bool push (const GateTelemetryRecord& record) noexcept
+    {
+        const auto scope = fifo.write (1);
+
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+        {
+            dropped.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+
+        records[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = record;
+        return true;
+    }
+
+    //==============================================================================
+    // Hilo de la GUI: copia hasta maxRecords registros, del más antiguo al
+    // más reciente. Devuelve cuántos ha copiado.
+    int pop (GateTelemetryRecord* dest, int maxRecords) noexcept
+    {
+        const auto scope = fifo.read (juce::jmin (maxRecords, fifo.getNumReady()));
+        scope.forEach ([&] (int index) { *dest++ = records[(size_t) index]; });
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    // Hilo de la GUI: descarta lo acumulado (p. ej. al abrir el editor)
+    void discardAll() noexcept
+    {
+        fifo.read (fifo.getNumReady());
+    }
+
+    int getNumReady() const noexcept                { return fifo.getNumReady(); }
+    juce::uint64 getNumDropped() const noexcept     { return dropped.load (std::memory_order_relaxed); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<GateTelemetryRecord, (size_t) capacity> records {};
+    std::atomic<juce::uint64> dropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (GateTelemetryFifo)
+};
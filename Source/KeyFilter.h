@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+    KeyFilter.h
+
+    Filtro de la señal de detección (key) de la puerta: paso alto, paso bajo
+    o paso banda delante del detector de nivel, para que el retumbe o el
+    sangrado fuera de banda no abran la puerta. Solo afecta a la detección;
+    el audio que sale nunca pasa por aquí.
+
+    Dos biquads en cascada (TDF-II, coeficientes del RBJ cookbook):
+      - highPass / lowPass: Butterworth de 4º orden (24 dB/oct)
+      - bandPass: dos paso banda de 0 dB en el centro (Q = 0.707 cada uno)
+
+    La recursión de un biquad es serie en el tiempo, así que se vectoriza
+    entre canales: process() filtra un canal por bloque con las dos etapas
+    fusionadas en el mismo bucle (la etapa 1 de la muestra n+1 se solapa con
+    la etapa 2 de la muestra n), y processInterleaved() filtra un buffer
+    [muestra][canal] con el bucle interno sobre los canales, que el
+    compilador vectoriza igual que la balística entrelazada del motor
+    multicanal. Estado como estructura de arrays: [etapa][z1/z2][canal].
+
+    Sin reservas fuera de prepare(). Con el filtro en off no se llama nunca.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Valores del parámetro KEY_FILTER (mismo orden que las opciones del APVTS)
+enum class KeyFilterMode
+{
+    off = 0,
+    highPass,
+    lowPass,
+    bandPass
+};
+
+//==============================================================================
+template <typename SampleType>
+class KeyFilter
+{
+public:
+    static constexpr int numStages = 2;
+
+    static constexpr float minFrequencyHz = 20.0f;
+    static constexpr float maxFrequencyHz = 20000.0f;
+
+    //==============================================================================
+    // Reserva el estado de maxChannels canales (uno por canal de detección)
+    void prepare (double newSampleRate, int maxChannels)
+    {
+        sampleRate  = newSampleRate;
+        numChannels = juce::jmax (1, maxChannels);
+
+        state.allocate ((size_t) (numStages * 2 * numChannels), true);
+
+        // Forzar el cálculo de coeficientes en el próximo setParameters
+        mode = KeyFilterMode::off;
+        frequencyHz = -1.0f;
+    }
+
+    void reset() noexcept
+    {
+        if (state != nullptr)
+            juce::FloatVectorOperations::clear (state.get(), numStages * 2 * numChannels);
+    }
+
+    // Pensado para llamarse en cada bloque: solo recalcula si algo cambió.
+    // La frecuencia salta sin rampa: el filtro solo alimenta al detector.
+    void setParameters (KeyFilterMode newMode, float newFrequencyHz) noexcept
+    {
+        const auto maxHz = (float) (0.45 * sampleRate);
+        newFrequencyHz = juce::jlimit (minFrequencyHz, juce::jmin (maxFrequencyHz, maxHz), newFrequencyHz);
+
+        if (newMode == mode && newFrequencyHz == frequencyHz)
+            return;
+
+        // Al activar o cambiar de tipo, el estado anterior no sirve
+        if (newMode != mode)
+            reset();
+
+        mode = newMode;
+        frequencyHz = newFrequencyHz;
+
+        if (mode != KeyFilterMode::off)
+            updateCoefficients();
+    }
+
+    bool isActive() const noexcept            { return mode != KeyFilterMode::off; }
+    KeyFilterMode getMode() const noexcept     { return mode; }
+    float getFrequencyHz() const noexcept      { return frequencyHz; }
+
+    //==============================================================================
+    // Filtra numSamples muestras del canal dado (out puede ser igual a in)
+    void process (int channel, const SampleType* in, SampleType* out, int numSamples) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (channel, numChannels));
+
+        const auto c0 = coefficients[0];
+        const auto c1 = coefficients[1];
+
+        auto& z10 = stateAt (0, 0, channel);
+        auto& z20 = stateAt (0, 1, channel);
+        auto& z11 = stateAt (1, 0, channel);
+        auto& z21 = stateAt (1, 1, channel);
+
+        // Estado en registros durante todo el bloque
+        SampleType s10 = z10, s20 = z20, s11 = z11, s21 = z21;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType x = in[i];
+
+            const SampleType y0 = c0.b0 * x + s10;
+            s10 = c0.b1 * x - c0.a1 * y0 + s20;
+            s20 = c0.b2 * x - c0.a2 * y0;
+
+            const SampleType y1 = c1.b0 * y0 + s11;
+            s11 = c1.b1 * y0 - c1.a1 * y1 + s21;
+            s21 = c1.b2 * y0 - c1.a2 * y1;
+
+            out[i] = y1;
+        }
+
+        z10 = s10;  z20 = s20;
+        z11 = s11;  z21 = s21;
+    }
+
+    // Filtra in situ un buffer entrelazado [muestra][canal] de frameChannels
+    // canales (los primeros frameChannels estados). El bucle interno recorre
+    // los canales: sin dependencias entre ellos, se vectoriza.
+    void processInterleaved (SampleType* frames, int numSamples, int frameChannels) noexcept
+    {
+        jassert (frameChannels <= numChannels);
+
+        for (int s = 0; s < numStages; ++s)
+        {
+            const auto c = coefficients[s];
+            auto* z1 = &stateAt (s, 0, 0);
+            auto* z2 = &stateAt (s, 1, 0);
+
+            // Etapa a etapa sobre el tramo completo: el estado de la etapa
+            // (2 x frameChannels valores) se queda en caché L1
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto* frame = frames + i * frameChannels;
+
+                for (int ch = 0; ch < frameChannels; ++ch)
+                {
+                    const SampleType x = frame[ch];
+                    const SampleType y = c.b0 * x + z1[ch];
+                    z1[ch] = c.b1 * x - c.a1 * y + z2[ch];
+                    z2[ch] = c.b2 * x - c.a2 * y;
+                    frame[ch] = y;
+                }
+            }
+        }
+    }
+
+    // Versión muestra a muestra (rutas de referencia)
+    SampleType processSample (int channel, SampleType x) noexcept
+    {
+        for (int s = 0; s < numStages; ++s)
+        {
+            const auto& c = coefficients[s];
+            auto& z1 = stateAt (s, 0, channel);
+            auto& z2 = stateAt (s, 1, channel);
+
+            const SampleType y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            x = y;
+        }
+
+        return x;
+    }
+
+private:
+    struct Coefficients
+    {
+        SampleType b0 = SampleType (1), b1 = SampleType (0), b2 = SampleType (0);
+        SampleType a1 = SampleType (0), a2 = SampleType (0);
+    };
+
+    SampleType& stateAt (int stage, int index, int channel) noexcept
+    {
+        return state[(stage * 2 + index) * numChannels + channel];
+    }
+
+    // Coeficientes en double y normalizados por a0
+    void updateCoefficients() noexcept
+    {
+        // Q de las dos secciones de un Butterworth de 4º orden
+        static constexpr double butterworthQ[numStages] = { 0.54119610014619690, 1.30656296487637660 };
+
+        const double w0   = juce::MathConstants<double>::twoPi * frequencyHz / sampleRate;
+        const double cosW = std::cos (w0);
+        const double sinW = std::sin (w0);
+
+        for (int s = 0; s < numStages; ++s)
+        {
+            const double q     = mode == KeyFilterMode::bandPass ? juce::MathConstants<double>::sqrt2 * 0.5 : butterworthQ[s];
+            const double alpha = sinW / (2.0 * q);
+            const double a0    = 1.0 + alpha;
+
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+
+            switch (mode)
+            {
+                case KeyFilterMode::highPass:
+                    b0 = (1.0 + cosW) * 0.5;
+                    b1 = -(1.0 + cosW);
+                    b2 = b0;
+                    break;
+
+                case KeyFilterMode::lowPass:
+                    b0 = (1.0 - cosW) * 0.5;
+                    b1 = 1.0 - cosW;
+                    b2 = b0;
+                    break;
+
+                case KeyFilterMode::bandPass:
+                    b0 = alpha;
+                    b1 = 0.0;
+                    b2 = -alpha;
+                    break;
+
+                case KeyFilterMode::off:
+                default:
+                    b0 = a0;
+                    break;
+            }
+
+            auto& c = coefficients[s];
+            c.b0 = (SampleType) (b0 / a0);
+            c.b1 = (SampleType) (b1 / a0);
+            c.b2 = (SampleType) (b2 / a0);
+            c.a1 = (SampleType) (-2.0 * cosW / a0);
+            c.a2 = (SampleType) ((1.0 - alpha) / a0);
+        }
+    }
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    int numChannels   = 1;
+
+    KeyFilterMode mode = KeyFilterMode::off;
+    float frequencyHz  = -1.0f;
+
+    Coefficients coefficients[numStages];
+    juce::HeapBlock<SampleType> state;   // [etapa][z1/z2][canal]
+};
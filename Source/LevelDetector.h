@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+    LevelDetector.h
+
+    Modos del detector de nivel de la puerta (parámetro DETECTOR):
+      - peak:     |x| muestra a muestra (el detector de siempre).
+                  Coste: 1 abs + 1 max por canal y muestra (FloatVectorOperations).
+      - rms:      media cuadrática en una ventana deslizante de RMS_WINDOW ms
+                  sobre el nivel ya rectificado (y enlazado) de cada detector.
+                  Coste: 1 mul + 2 sumas + 1 sqrt por detector y muestra, más
+                  1 suma amortizada por el re-sumado periódico.
+      - truePeak: pico entre muestras con sobremuestreo x4 (FIR polifásico de
+                  48 coeficientes, 12 por fase, como el de ITU-R BS.1770).
+                  Coste: 48 multiplicaciones-suma + 4 abs/max por canal y
+                  muestra. Retrasa la detección ~5.5 muestras (no se compensa;
+                  es muy inferior a cualquier ataque útil).
+
+    RunningRms: buffer circular de cuadrados con suma acumulada, O(1) por
+    muestra. La suma acumulada arrastra error de redondeo (sobre todo en
+    float), así que cada windowLength muestras se recalcula desde el buffer.
+
+    TruePeakDetector: historia por canal duplicada (cada muestra se escribe
+    dos veces) para que la ventana de 12 muestras sea siempre contigua; cada
+    fase es un producto escalar con 4 sumas parciales independientes, que
+    el compilador vectoriza entre coeficientes sin reordenar sumas. Los
+    coeficientes (TruePeakCoefficients) se diseñan una vez por proceso y se
+    comparten entre todos los detectores (SharedResources.h).
+
+    Toda la memoria se reserva en prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedResources.h"
+
+//==============================================================================
+// Valores del parámetro DETECTOR (mismo orden que las opciones del APVTS)
+enum class DetectorMode
+{
+    peak = 0,
+    rms,
+    truePeak
+};
+
+//==============================================================================
+template <typename SampleType>
+class RunningRms
+{
+public:
+    static constexpr float minWindowMs = 1.0f;
+    static constexpr float maxWindowMs = 300.0f;
+
+    static int windowMsToSamples (float windowMs, double sampleRate) noexcept
+    {
+        return juce::jmax (1, juce::roundToInt (juce::jlimit (minWindowMs, maxWindowMs, windowMs) * 0.001 * sampleRate));
+    }
+
+    // Reserva el buffer para ventanas de hasta maxWindowLength muestras
+    void prepare (int maxWindowLength)
+    {
+        capacity = juce::jmax (1, maxWindowLength);
+        squares.allocate ((size_t) capacity, true);
+        setWindowLength (1);
+    }
+
+    // Cambia la longitud de la ventana (dentro de la capacidad). Vacía la ventana.
+    void setWindowLength (int newLength) noexcept
+    {
+        windowLength = juce::jlimit (1, capacity, newLength);
+        inverseLength = SampleType (1) / (SampleType) windowLength;
+        reset();
+    }
+
+    int getWindowLength() const noexcept  { return windowLength; }
+
+    void reset() noexcept
+    {
+        if (squares != nullptr)
+            juce::FloatVectorOperations::clear (squares.get(), windowLength);
+
+        sum = SampleType (0);
+        position = 0;
+    }
+
+    // Añade un nivel y devuelve el RMS de las últimas windowLength muestras
+    SampleType push (SampleType level) noexcept
+    {
+        const SampleType square = level * level;
+        sum += square - squares[position];
+        squares[position] = square;
+
+        if (++position == windowLength)
+        {
+            // Re-sumado periódico: una vez por ventana (O(1) amortizado)
+            position = 0;
+            resum();
+        }
+
+        return std::sqrt (juce::jmax (SampleType (0), sum) * inverseLength);
+    }
+
+    // Versión por bloque, in situ: data[i] = RMS de la ventana que termina en i
+    void process (SampleType* data, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = push (data[i]);
+    }
+
+private:
+    void resum() noexcept
+    {
+        SampleType total = SampleType (0);
+
+        for (int i = 0; i < windowLength; ++i)
+            total += squares[i];
+
+        sum = total;
+    }
+
+    juce::HeapBlock<SampleType> squares;
+    int capacity      = 0;
+    int windowLength  = 1;
+    int position      = 0;
+    SampleType sum    = SampleType (0);
+    SampleType inverseLength = SampleType (1);
+};
+
+//==============================================================================
+// Filtro polifásico del sobremuestreo x4: de solo lectura, una copia por
+// proceso y tipo de muestra. La clave del pool no se usa (hay un solo diseño).
+template <typename SampleType>
+struct TruePeakCoefficients
+{
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+
+    explicit TruePeakCoefficients (int /*key*/) noexcept
+    {
+        designFilter();
+    }
+
+    size_t getSizeInBytes() const noexcept  { return sizeof (*this); }
+
+    // Alineado a línea de caché: las 4 fases caben en 3 (float) o 6 (double) líneas
+    alignas (64) SampleType phases[oversampling][tapsPerPhase] = {};
+
+private:
+    // Sinc enventanada (Blackman) de oversampling * tapsPerPhase coeficientes
+    // con el corte en la Nyquist original; cada fase se normaliza a ganancia 1
+    // en continua. Los coeficientes de cada fase se guardan en el orden de la
+    // ventana (de la muestra más antigua a la más reciente).
+    void designFilter() noexcept
+    {
+        constexpr int length = oversampling * tapsPerPhase;
+        const double centre  = 0.5 * (length - 1);
+
+        double prototype[length];
+
+        for (int n = 0; n < length; ++n)
+        {
+            const double t    = (n - centre) / oversampling;
+            const double sinc = std::abs (t) < 1.0e-12 ? 1.0 : std::sin (juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+            const double w    = juce::MathConstants<double>::twoPi * n / (length - 1);
+            prototype[n] = sinc * (0.42 - 0.5 * std::cos (w) + 0.08 * std::cos (2.0 * w));
+        }
+
+        for (int phase = 0; phase < oversampling; ++phase)
+        {
+            double dc = 0.0;
+
+            for (int k = 0; k < tapsPerPhase; ++k)
+                dc += prototype[phase + oversampling * k];
+
+            // y_fase[n] = sum_k h[fase + 4k] * x[n - k]; la ventana va de x[n - 11] a x[n]
+            for (int j = 0; j < tapsPerPhase; ++j)
+                phases[phase][j] = (SampleType) (prototype[phase + oversampling * (tapsPerPhase - 1 - j)] / dc);
+        }
+    }
+};
+
+//==============================================================================
+template <typename SampleType>
+class TruePeakDetector
+{
+public:
+    using Coefficients = TruePeakCoefficients<SampleType>;
+
+    static constexpr int oversampling = Coefficients::oversampling;
+    static constexpr int tapsPerPhase = Coefficients::tapsPerPhase;   // múltiplo de numLanes
+    static constexpr int numLanes     = 4;    // sumas parciales por producto escalar
+
+    // Reserva la historia de numChannels canales y toma el filtro del pool
+    void prepare (int numChannels)
+    {
+        channels = juce::jmax (1, numChannels);
+        history.allocate ((size_t) (channels * 2 * tapsPerPhase), true);
+        positions.allocate ((size_t) channels, true);
+
+        if (coefficients == nullptr)
+            coefficients = juce::SharedResourcePointer<SharedResourcePool>()->get<Coefficients> (0);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        if (history != nullptr)
+            juce::FloatVectorOperations::clear (history.get(), channels * 2 * tapsPerPhase);
+
+        for (int ch = 0; ch < channels; ++ch)
+            positions[ch] = 0;
+    }
+
+    // Pico x4 rectificado de cada muestra: out[i] = max |y_fase|. out puede ser in.
+    void process (int channel, const SampleType* in, SampleType* out, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = processSample (channel, in[i]);
+    }
+
+    SampleType processSample (int channel, SampleType x) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (channel, channels));
+        jassert (coefficients != nullptr);   // processSample() llamado sin prepare()
+
+        auto* buffer = history.get() + channel * 2 * tapsPerPhase;
+        int& position = positions[channel];
+
+        // Escribir dos veces: buffer[position + 1 .. position + tapsPerPhase]
+        // contiene siempre las últimas tapsPerPhase muestras, de la más antigua
+        // a la más reciente
+        buffer[position] = x;
+        buffer[position + tapsPerPhase] = x;
+
+        const SampleType* window = buffer + position + 1;
+        position = (position + 1 == tapsPerPhase) ? 0 : position + 1;
+
+        SampleType peak = SampleType (0);
+
+        for (int phase = 0; phase < oversampling; ++phase)
+        {
+            const SampleType* c = coefficients->phases[phase];
+            SampleType lanes[numLanes] = {};
+
+            for (int k = 0; k < tapsPerPhase; k += numLanes)
+                for (int lane = 0; lane < numLanes; ++lane)
+                    lanes[lane] += c[k + lane] * window[k + lane];
+
+            const SampleType y = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            peak = juce::jmax (peak, std::abs (y));
+        }
+
+        return peak;
+    }
+
+private:
+    static_assert (tapsPerPhase % numLanes == 0, "TruePeakDetector: tapsPerPhase debe ser múltiplo de numLanes");
+
+    std::shared_ptr<const Coefficients> coefficients;   // compartidos (SharedResourcePool)
+    juce::HeapBlock<SampleType> history;   // [canal][2 * tapsPerPhase]
+    juce::HeapBlock<int> positions;
+    int channels = 1;
+};
@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    Lookahead.h
+
+    Piezas del lookahead de la puerta:
+      - SlidingWindowMax: máximo de ventana deslizante con deque monótona,
+        O(1) amortizado por muestra sea cual sea la longitud de la ventana.
+      - LookaheadDelay: línea de retardo circular por canal para el audio.
+
+    Toda la memoria se reserva en prepare(); cambiar la longitud en tiempo
+    de ejecución (dentro del máximo preparado) nunca reserva ni borra el
+    historial: solo reset() lo vacía.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+template <typename SampleType>
+class SlidingWindowMax
+{
+public:
+    // Reserva la deque para ventanas de hasta maxWindowLength muestras
+    void prepare (int maxWindowLength)
+    {
+        capacity = juce::jmax (1, maxWindowLength);
+        values.allocate ((size_t) capacity, true);
+        indices.allocate ((size_t) capacity, true);
+        setWindowLength (1);
+        reset();
+    }
+
+    // Cambia la longitud de la ventana (1 = sin ventana). La deque se conserva:
+    // al acortarla, los elementos que quedan fuera salen en el siguiente push().
+    void setWindowLength (int newLength) noexcept
+    {
+        windowLength = juce::jlimit (1, juce::jmax (1, capacity), newLength);
+    }
+
+    int getWindowLength() const noexcept  { return windowLength; }
+
+    void reset() noexcept
+    {
+        head = 0;
+        size = 0;
+        counter = 0;
+    }
+
+    // Añade una muestra y devuelve el máximo de las últimas windowLength muestras
+    SampleType push (SampleType value) noexcept
+    {
+        // 1. Descartar por delante los elementos que salen de la ventana
+        //    (antes de insertar, para no superar nunca la capacidad)
+        while (size > 0 && indices[head] <= counter - windowLength)
+        {
+            head = (head + 1 == capacity) ? 0 : head + 1;
+            --size;
+        }
+
+        // 2. Descartar por detrás los elementos dominados por el nuevo valor
+        while (size > 0 && values[wrap (head + size - 1)] <= value)
+            --size;
+
+        const int tail = wrap (head + size);
+        values[tail]  = value;
+        indices[tail] = counter;
+        ++size;
+        ++counter;
+
+        return values[head];
+    }
+
+    // Versión por bloque, in situ: data[i] = máximo de la ventana que termina en i
+    void process (SampleType* data, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = push (data[i]);
+    }
+
+private:
+    int wrap (int index) const noexcept  { return index >= capacity ? index - capacity : index; }
+
+    juce::HeapBlock<SampleType> values;
+    juce::HeapBlock<juce::int64> indices;
+    int capacity = 0, windowLength = 1;
+    int head = 0, size = 0;
+    juce::int64 counter = 0;
+};
+
+//==============================================================================
+template <typename SampleType, int NumChannels>
+class LookaheadDelay
+{
+public:
+    // El anillo cubre el retardo máximo más un bloque completo: así se puede
+    // escribir el bloque entero antes de leerlo sin pisar muestras pendientes.
+    void prepare (int maxDelaySamples, int maxBlockSize)
+    {
+        ringSize = juce::jmax (1, maxDelaySamples) + juce::jmax (1, maxBlockSize);
+
+        for (auto& ring : rings)
+            ring.allocate ((size_t) ringSize, true);
+
+        delay = 0;
+        writePos = 0;
+    }
+
+    // Cambia el retardo moviendo solo la posición de lectura: el anillo guarda
+    // las últimas muestras escritas, así que el audio sigue sin huecos. Con
+    // retardo 0 no se escribe en el anillo; quien lo active de nuevo debe
+    // llamar a reset() para no leer audio antiguo.
+    void setDelay (int newDelaySamples) noexcept
+    {
+        delay = juce::jlimit (0, juce::jmax (0, ringSize - 1), newDelaySamples);
+    }
+
+    int getDelay() const noexcept  { return delay; }
+
+    void reset() noexcept
+    {
+        for (auto& ring : rings)
+            juce::FloatVectorOperations::clear (ring.get(), ringSize);
+
+        writePos = 0;
+    }
+
+    // Retrasa in situ numSamples muestras (<= maxBlockSize) de cada canal
+    void process (SampleType* const* channels, int offset, int numSamples) noexcept
+    {
+        const int readPos = wrap (writePos - delay + ringSize);
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            auto* data = channels[ch] + offset;
+            auto* ring = rings[ch].get();
+
+            // Escribir primero el bloque y luego leer el retardado (copias vectoriales)
+            const int firstWrite = juce::jmin (numSamples, ringSize - writePos);
+            juce::FloatVectorOperations::copy (ring + writePos, data, firstWrite);
+            juce::FloatVectorOperations::copy (ring, data + firstWrite, numSamples - firstWrite);
+
+            const int firstRead = juce::jmin (numSamples, ringSize - readPos);
+            juce::FloatVectorOperations::copy (data, ring + readPos, firstRead);
+            juce::FloatVectorOperations::copy (data + firstRead, ring, numSamples - firstRead);
+        }
+
+        writePos = wrap (writePos + numSamples);
+    }
+
+    // Copia en dest las getDelay() muestras del canal que aún no han salido,
+    // de la más antigua a la más reciente (relevo entre motores)
+    void copyPending (int channel, SampleType* dest) const noexcept
+    {
+        const auto* ring = rings[channel].get();
+        const int readPos = wrap (writePos - delay + ringSize);
+        const int first = juce::jmin (delay, ringSize - readPos);
+
+        juce::FloatVectorOperations::copy (dest, ring + readPos, first);
+        juce::FloatVectorOperations::copy (dest + first, ring, delay - first);
+    }
+
+    // Versión muestra a muestra (ruta escalar de referencia)
+    SampleType processSample (int channel, SampleType input) noexcept
+    {
+        auto* ring = rings[channel].get();
+        ring[writePos] = input;
+        return ring[wrap (writePos - delay + ringSize)];
+    }
+
+    // Avanza la posición de escritura tras procesar una muestra de todos los canales
+    void advance() noexcept
+    {
+        writePos = wrap (writePos + 1);
+    }
+
+private:
+    int wrap (int index) const noexcept  { return index >= ringSize ? index - ringSize : index; }
+
+    juce::HeapBlock<SampleType> rings[NumChannels];
+    int ringSize = 0, delay = 0, writePos = 0;
+};
@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+    MultibandGateEngine.h
+
+    Puerta multibanda (2 a 4 bandas) para que el ruido grave de climatización
+    no pase cada vez que alguien habla. El bus se divide con
+    LinkwitzRileySplitter (Crossover.h), cada banda pasa por su propio motor
+    de puerta (MultichannelGateEngine: mismo kernel vectorizado, con su
+    umbral, ratio y envolvente) y las bandas se vuelven a sumar en fase.
+
+    Ruta rápida de banda abierta: el motor de cada banda ya deja intacto un
+    sub-bloque asentado abierto (solo detecta), así que una banda abierta
+    cuesta el filtro de cruce, la detección y la suma. Una banda con ratio
+    1:1 y sin lookahead no puede cerrar: ni siquiera se llama a su motor.
+
+    La detección de cada banda usa su propia señal: la key externa y el
+    filtro de key son del modo de banda ancha. Ataque, release, lookahead,
+    detector y modo de enlace son comunes a todas las bandas.
+
+    Todos los buffers de banda se reservan en prepare() (prepareToPlay).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Crossover.h"
+#include "MultichannelGateEngine.h"
+
+//==============================================================================
+// Parámetros propios del modo multibanda (los comunes van en GateParameters)
+struct MultibandParameters
+{
+    int numBands = 1;                                      // 1 = banda ancha
+    float crossoverHz[3] = { 150.0f, 1000.0f, 5000.0f };   // Hz
+    float thresholdDb[4] = { -60.0f, -60.0f, -60.0f, -60.0f };
+    float ratio[4]       = { 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+//==============================================================================
+template <typename SampleType>
+class MultibandGateEngine
+{
+public:
+    using Splitter   = LinkwitzRileySplitter<SampleType>;
+    using BandEngine = MultichannelGateEngine<SampleType>;
+    using PathCounts = GatePathCounts;
+
+    static constexpr int maxBands = Splitter::maxBands;
+
+    // Tramo máximo que se divide en bandas de una vez
+    static constexpr int maxChunkSize = 512;
+
+    //==============================================================================
+    void prepare (double sampleRate, int maximumBlockSize, const juce::AudioChannelSet& layout)
+    {
+        numChannels = juce::jlimit (1, BandEngine::maxChannels, layout.size());
+        chunkSize   = juce::jlimit (1, maxChunkSize, maximumBlockSize);
+
+        splitter.prepare (sampleRate, numChannels);
+
+        for (auto& band : bands)
+            band.prepare (sampleRate, chunkSize, layout);
+
+        // [banda][canal][muestra] y tablas de punteros para el divisor y los motores
+        bandBuffers.allocate ((size_t) (maxBands * numChannels * chunkSize), true);
+
+        for (int b = 0; b < maxBands; ++b)
+        {
+            bandPointers[b].allocate ((size_t) numChannels, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                bandPointers[b][ch] = bandBuffers.get() + (b * numChannels + ch) * chunkSize;
+        }
+
+        numBands = 2;
+        splitter.setCrossovers (numBands, MultibandParameters().crossoverHz);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        splitter.reset();
+
+        for (auto& band : bands)
+            band.reset();
+    }
+
+    // Parámetros comunes: los de GateParameters salvo umbral/ratio (por banda)
+    void setParameters (const GateParameters& params) noexcept
+    {
+        for (int b = 0; b < maxBands; ++b)
+        {
+            auto bandParams = params;
+            bandParams.thresholdDb = bandSettings.thresholdDb[b];
+            bandParams.ratio       = bandSettings.ratio[b];
+            bandParams.keyFilter   = KeyFilterMode::off;
+            bands[b].setParameters (bandParams);
+        }
+    }
+
+    void setMultibandParameters (const MultibandParameters& newSettings) noexcept
+    {
+        bandSettings = newSettings;
+
+        if (bandPointers[0] == nullptr)
+            return;
+
+        const int newNumBands = juce::jlimit (2, maxBands, bandSettings.numBands);
+
+        // Las bandas que entran parten de la GR de las que ya estaban
+        if (newNumBands > numBands)
+            for (int b = numBands; b < newNumBands; ++b)
+                bands[b].setEnvelope (getEnvelope());
+
+        numBands = newNumBands;
+        splitter.setCrossovers (numBands, bandSettings.crossoverHz);
+    }
+
+    void setLinkMode (GateLinkMode mode) noexcept
+    {
+        for (auto& band : bands)
+            band.setLinkMode (mode);
+    }
+
+    void setFastMathEnabled (bool shouldUseFastMath) noexcept
+    {
+        for (auto& band : bands)
+            band.setFastMathEnabled (shouldUseFastMath);
+    }
+
+    int getNumBands() const noexcept            { return numBands; }
+    int getNumChannels() const noexcept         { return numChannels; }
+    int getLatencySamples() const noexcept      { return bands[0].getLatencySamples(); }
+
+    // GR de la banda más cerrada
+    SampleType getEnvelope() const noexcept
+    {
+        SampleType deepest = SampleType (0);
+
+        for (int b = 0; b < numBands; ++b)
+            deepest = juce::jmin (deepest, bands[b].getEnvelope());
+
+        return deepest;
+    }
+
+    void setEnvelope (SampleType newEnvelope) noexcept
+    {
+        for (auto& band : bands)
+            band.setEnvelope (newEnvelope);
+    }
+
+    // Las bandas retienen la señal ya dividida, no la entrada: no hay nada que
+    // pasar a otro motor en un relevo
+    int copyPendingInput (SampleType* const*) const noexcept  { return 0; }
+
+    // Suma de los sub-bloques de todas las bandas en la última llamada a process()
+    const PathCounts& getLastPathCounts() const noexcept  { return lastPathCounts; }
+
+    //==============================================================================
+    // Procesa in situ los getNumChannels() canales. keyChannels se ignora: cada
+    // banda detecta sobre su propia señal. Devuelve la GR de la banda más cerrada.
+    SampleType process (SampleType* const* channels, int numSamples,
+                        const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        return processBands<false> (channels, numSamples, keyChannels);
+    }
+
+    // Igual, con la ruta escalar de referencia de cada banda
+    SampleType processReference (SampleType* const* channels, int numSamples,
+                                 const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        return processBands<true> (channels, numSamples, keyChannels);
+    }
+
+private:
+    // Banda que ya no actúa: su señal pasa tal cual. Se exige que el motor de
+    // la banda haya terminado la rampa hasta 1:1 y que su envolvente esté en
+    // 0 dB; hasta entonces sigue procesando (una banda cerrada que pasa a 1:1
+    // se abre con su release, sin salto de ganancia).
+    bool isBandBypassed (int band) const noexcept
+    {
+        return bands[band].isTransparent();
+    }
+
+    template <bool UseReference>
+    SampleType processBands (SampleType* const* channels, int numSamples, const SampleType* const* keyChannels) noexcept
+    {
+        juce::ignoreUnused (keyChannels);
+
+        if (bandBuffers == nullptr)
+        {
+            jassertfalse; // process() llamado sin prepare()
+            return SampleType (0);
+        }
+
+        SampleType maxGR = SampleType (0);
+        lastPathCounts = {};
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int chunk = juce::jmin (chunkSize, numSamples - start);
+
+            // 1. Dividir en bandas (compensadas en fase)
+            for (int ch = 0; ch < numChannels; ++ch)
+                inputPointers[ch] = channels[ch] + start;
+
+            for (int b = 0; b < numBands; ++b)
+                splitPointers[b] = bandPointers[b].get();
+
+            splitter.split (inputPointers, splitPointers, chunk);
+
+            // 2. Puerta de cada banda (in situ en su buffer)
+            for (int b = 0; b < numBands; ++b)
+            {
+                if (isBandBypassed (b))
+                {
+                    bands[b].setEnvelope (SampleType (0));   // al volver a cerrar, partir de abierta
+                    lastPathCounts.open += (juce::uint64) ((chunk + GateEngine<SampleType, 1>::fastPathBlockSize - 1)
+                                                           / GateEngine<SampleType, 1>::fastPathBlockSize);
+                    continue;
+                }
+
+                auto* const* bandChannels = bandPointers[b].get();
+                const SampleType bandGR = UseReference ? bands[b].processReference (bandChannels, chunk)
+                                                       : bands[b].process (bandChannels, chunk);
+                maxGR = juce::jmin (maxGR, bandGR);
+
+                const auto& counts = bands[b].getLastPathCounts();
+                lastPathCounts.open   += counts.open;
+                lastPathCounts.closed += counts.closed;
+                lastPathCounts.full   += counts.full;
+            }
+
+            // 3. Suma de las bandas
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* out = channels[ch] + start;
+                juce::FloatVectorOperations::copy (out, bandPointers[0][ch], chunk);
+
+                for (int b = 1; b < numBands; ++b)
+                    juce::FloatVectorOperations::add (out, bandPointers[b][ch], chunk);
+            }
+        }
+
+        return maxGR;
+    }
+
+    //==============================================================================
+    int numChannels = 1;
+    int chunkSize   = maxChunkSize;
+    int numBands    = 2;
+
+    MultibandParameters bandSettings;
+    PathCounts lastPathCounts;
+
+    Splitter splitter;
+    BandEngine bands[maxBands];
+
+    // --- Buffers de banda (reservados en prepare) ---
+    juce::HeapBlock<SampleType> bandBuffers;             // [banda][canal][muestra]
+    juce::HeapBlock<SampleType*> bandPointers[maxBands]; // [banda][canal]
+    SampleType* const* splitPointers[maxBands] = {};
+    const SampleType* inputPointers[BandEngine::maxChannels] = {};
+};
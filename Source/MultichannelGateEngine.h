@@ -0,0 +1,712 @@
+/*
+  ==============================================================================
+
+    MultichannelGateEngine.h
+
+    Puerta para buses de cualquier tamaño (5.1, 7.1.4, ambisónico...) con el
+    número de canales fijado en prepare(). Los canales se reparten en grupos
+    de detección según el modo de enlace:
+      - linked:   un solo detector para todos los canales (como GateEngine)
+      - unlinked: un detector por canal
+      - grouped:  un detector por función de canal (frontales, LFE,
+                  surround, alturas); un bus ambisónico es un único grupo
+
+    Los detectores se guardan como estructura de arrays: un plano de
+    sub-bloque por grupo para las etapas vectorizadas en el tiempo (nivel,
+    dB, gain computer, ganancia) y un buffer entrelazado [muestra][grupo]
+    para la balística, cuyo bucle interno recorre los grupos y se vectoriza
+    entre canales. Los grupos asentados (abiertos o cerrados) se saltan.
+    El filtro de key (KeyFilter) usa el mismo buffer entrelazado, con un
+    canal por carril. Detector peak, RMS (una ventana por grupo) o true peak
+    (un estado por canal), ver LevelDetector.h.
+
+    Mismas fórmulas que GateEngine (GateGainComputer) y mismas garantías:
+    ninguna reserva fuera de prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "GateEngine.h"
+
+//==============================================================================
+// Valores del parámetro LINK (mismo orden que las opciones del APVTS)
+enum class GateLinkMode
+{
+    linked = 0,
+    unlinked,
+    grouped
+};
+
+//==============================================================================
+template <typename SampleType>
+class MultichannelGateEngine
+{
+public:
+    using GainComputer = GateGainComputer<SampleType>;
+    using PathCounts   = GatePathCounts;
+
+    static constexpr int maxChannels  = 64;
+    static constexpr int numLinkModes = 3;
+
+    static int lookaheadMsToSamples (float lookaheadMs, double sampleRate) noexcept
+    {
+        return GateEngine<SampleType, 1>::lookaheadMsToSamples (lookaheadMs, sampleRate);
+    }
+
+    //==============================================================================
+    // Reparte los canales de layout en grupos según el modo. Escribe el grupo
+    // de cada canal en groupOfChannel (layout.size() entradas) y devuelve el
+    // número de grupos.
+    static int buildGroups (const juce::AudioChannelSet& layout, GateLinkMode mode, int* groupOfChannel)
+    {
+        const int numChannelsInLayout = juce::jlimit (1, maxChannels, layout.size());
+
+        if (mode == GateLinkMode::unlinked)
+        {
+            for (int ch = 0; ch < numChannelsInLayout; ++ch)
+                groupOfChannel[ch] = ch;
+
+            return numChannelsInLayout;
+        }
+
+        // Ambisónico: todos los componentes comparten ganancia o la imagen se deforma
+        if (mode == GateLinkMode::linked || layout.getAmbisonicOrder() >= 0)
+        {
+            for (int ch = 0; ch < numChannelsInLayout; ++ch)
+                groupOfChannel[ch] = 0;
+
+            return 1;
+        }
+
+        // grouped: numerar los grupos en el orden en que aparece cada función
+        int groupOfRole[numRoles];
+        std::fill (std::begin (groupOfRole), std::end (groupOfRole), -1);
+        int numGroups = 0;
+
+        for (int ch = 0; ch < numChannelsInLayout; ++ch)
+        {
+            auto& group = groupOfRole[getRole (layout.getTypeOfChannel (ch))];
+
+            if (group < 0)
+                group = numGroups++;
+
+            groupOfChannel[ch] = group;
+        }
+
+        return numGroups;
+    }
+
+    //==============================================================================
+    // Reserva para el bus dado (hasta maxChannels canales) y calcula de antemano
+    // los grupos de los tres modos, así que cambiar de modo nunca reserva.
+    void prepare (double newSampleRate, int maximumBlockSize, const juce::AudioChannelSet& layout)
+    {
+        sampleRate   = newSampleRate;
+        numChannels  = juce::jlimit (1, maxChannels, layout.size());
+        subBlockSize = juce::jmin (juce::jmax (1, maximumBlockSize), GateEngine<SampleType, 1>::fastPathBlockSize);
+
+        for (int m = 0; m < numLinkModes; ++m)
+        {
+            groupMaps[m].allocate ((size_t) numChannels, true);
+            numGroupsPerMode[m] = buildGroups (layout, (GateLinkMode) m, groupMaps[m].get());
+        }
+
+        // Planos por grupo (como mucho un grupo por canal)
+        const auto planeSize = (size_t) (numChannels * subBlockSize);
+        levelPlanes.allocate (planeSize, true);
+        gainPlanes.allocate  (planeSize, true);
+        interleaved.allocate (planeSize, true);
+        scratch.allocate ((size_t) subBlockSize, true);
+        thresholdRamp.allocate ((size_t) subBlockSize, true);
+        slopeRamp.allocate ((size_t) subBlockSize, true);
+
+        envelopes.allocate ((size_t) numChannels, true);
+        activeEnvelopes.allocate ((size_t) numChannels, true);
+        holdCounters.allocate ((size_t) numChannels, true);
+        activeHolds.allocate ((size_t) numChannels, true);
+        activeGroups.allocate ((size_t) numChannels, true);
+        groupPaths.allocate ((size_t) numChannels, true);
+        groupSeen.allocate ((size_t) numChannels, true);
+
+        gainComputer.prepare (sampleRate);
+
+        // Lookahead: una ventana por grupo posible y un retardo por canal
+        const int maxLookahead = lookaheadMsToSamples (GateEngine<SampleType, 1>::maxLookaheadMs, sampleRate);
+        peakWindows.resize ((size_t) numChannels);
+        lookaheadDelays.resize ((size_t) numChannels);
+
+        for (auto& window : peakWindows)
+            window.prepare (maxLookahead + 1);
+
+        for (auto& delay : lookaheadDelays)
+            delay.prepare (maxLookahead, subBlockSize);
+
+        keyFilter.prepare (sampleRate, numChannels);
+        truePeak.prepare (numChannels);
+
+        // RMS: una ventana por grupo posible
+        const int maxRmsLength = RunningRms<SampleType>::windowMsToSamples (RunningRms<SampleType>::maxWindowMs, sampleRate);
+        rmsWindows.resize ((size_t) numChannels);
+
+        for (auto& window : rmsWindows)
+            window.prepare (maxRmsLength);
+
+        detectorMode = DetectorMode::peak;
+        lookaheadSamples = 0;
+        linkMode  = GateLinkMode::linked;
+        numGroups = numGroupsPerMode[(int) linkMode];
+
+        reset();
+    }
+
+    // Reinicia las envolventes (puerta abierta) y el lookahead
+    void reset() noexcept
+    {
+        for (int g = 0; g < numChannels; ++g)
+        {
+            envelopes[g]    = SampleType (0);
+            holdCounters[g] = 0;
+        }
+
+        for (auto& window : peakWindows)
+            window.reset();
+
+        for (auto& delay : lookaheadDelays)
+            delay.reset();
+
+        keyFilter.reset();
+        truePeak.reset();
+
+        for (auto& window : rmsWindows)
+            window.reset();
+
+        gainComputer.reset();
+    }
+
+    void setParameters (const GateParameters& params) noexcept
+    {
+        gainComputer.setParameters (params);
+        keyFilter.setParameters (params.keyFilter, params.keyFrequencyHz);
+
+        // Cambiar de detector o de ventana RMS vacía su estado (sin reservar)
+        const int rmsLength = RunningRms<SampleType>::windowMsToSamples (params.rmsWindowMs, sampleRate);
+
+        if (! rmsWindows.empty() && (params.detector != detectorMode || rmsLength != rmsWindows.front().getWindowLength()))
+        {
+            detectorMode = params.detector;
+            truePeak.reset();
+
+            for (auto& window : rmsWindows)
+                window.setWindowLength (rmsLength);
+        }
+
+        const int lookahead = lookaheadMsToSamples (params.lookaheadMs, sampleRate);
+
+        // Igual que GateEngine: el audio retrasado se conserva al cambiar el
+        // lookahead y solo se vacía al activarlo desde 0
+        if (lookahead != lookaheadSamples && ! lookaheadDelays.empty())
+        {
+            for (auto& delay : lookaheadDelays)
+            {
+                if (lookaheadSamples == 0)
+                    delay.reset();
+
+                delay.setDelay (lookahead);
+            }
+
+            if (lookaheadSamples == 0)
+                for (auto& window : peakWindows)
+                    window.reset();
+
+            lookaheadSamples = lookaheadDelays.front().getDelay();
+
+            for (auto& window : peakWindows)
+                window.setWindowLength (lookaheadSamples + 1);
+        }
+    }
+
+    // Cambia los grupos de detección. Todos los grupos nuevos parten de la GR
+    // más profunda actual, con la puerta cerrada (sin hold): nada sube de
+    // golpe y el ataque abre lo que toque.
+    void setLinkMode (GateLinkMode newMode) noexcept
+    {
+        if (newMode == linkMode || envelopes == nullptr)
+            return;
+
+        const SampleType deepest = getEnvelope();
+
+        linkMode  = newMode;
+        numGroups = numGroupsPerMode[(int) linkMode];
+
+        for (int g = 0; g < numChannels; ++g)
+        {
+            envelopes[g]    = deepest;
+            holdCounters[g] = 0;
+        }
+
+        for (auto& window : peakWindows)
+            window.reset();
+
+        for (auto& window : rmsWindows)
+            window.reset();
+    }
+
+    GateLinkMode getLinkMode() const noexcept                  { return linkMode; }
+    int getNumChannels() const noexcept                        { return numChannels; }
+    int getNumGroups() const noexcept                          { return numGroups; }
+    int getNumGroups (GateLinkMode mode) const noexcept        { return numGroupsPerMode[(int) mode]; }
+
+    int getLatencySamples() const noexcept                     { return lookaheadSamples; }
+
+    void setFastMathEnabled (bool shouldUseFastMath) noexcept  { gainComputer.setFastMathEnabled (shouldUseFastMath); }
+
+    // GR del grupo más cerrado
+    SampleType getEnvelope() const noexcept
+    {
+        SampleType deepest = SampleType (0);
+
+        for (int g = 0; g < numGroups; ++g)
+            deepest = juce::jmin (deepest, envelopes[g]);
+
+        return deepest;
+    }
+
+    // Relevo entre motores: todos los grupos continúan desde esa GR
+    void setEnvelope (SampleType newEnvelope) noexcept
+    {
+        for (int g = 0; g < numChannels; ++g)
+            envelopes[g] = juce::jlimit (GainComputer::maxReductionDb(), SampleType (0), newEnvelope);
+    }
+
+    // Transparente: ratio 1:1 ya alcanzado, todos los grupos abiertos y sin
+    // lookahead. Procesar no cambiaría la señal.
+    bool isTransparent() const noexcept
+    {
+        return lookaheadSamples == 0 && gainComputer.isUnity()
+            && getEnvelope() >= SampleType (GainComputer::settledOpenDb);
+    }
+
+    // Relevo entre motores: copia en dest (getNumChannels() canales) la entrada
+    // que el lookahead aún retiene y devuelve cuántas muestras por canal son
+    int copyPendingInput (SampleType* const* dest) const noexcept
+    {
+        if (lookaheadSamples == 0)
+            return 0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            lookaheadDelays[(size_t) ch].copyPending (0, dest[ch]);
+
+        return lookaheadSamples;
+    }
+
+    // Sub-bloques (por grupo) procesados por cada ruta en la última llamada a process()
+    const PathCounts& getLastPathCounts() const noexcept       { return lastPathCounts; }
+
+    //==============================================================================
+    // Ruta vectorizada. channels (y keyChannels, si se da una señal de
+    // detección externa) deben tener getNumChannels() punteros.
+    // Devuelve la GR mínima (del grupo más cerrado) del bloque.
+    SampleType process (SampleType* const* channels, int numSamples,
+                        const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        if (levelPlanes == nullptr)
+        {
+            jassertfalse; // process() llamado sin prepare()
+            return SampleType (0);
+        }
+
+        SampleType maxGR = SampleType (0);
+        lastPathCounts = {};
+
+        for (int start = 0; start < numSamples; start += subBlockSize)
+        {
+            const int chunk = juce::jmin (subBlockSize, numSamples - start);
+            maxGR = juce::jmin (maxGR, processChunk (channels, keyChannels, start, chunk));
+        }
+
+        return maxGR;
+    }
+
+    // Ruta escalar de referencia, muestra a muestra y grupo a grupo
+    SampleType processReference (SampleType* const* channels, int numSamples,
+                                 const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        if (levelPlanes == nullptr)
+        {
+            jassertfalse; // processReference() llamado sin prepare()
+            return SampleType (0);
+        }
+
+        const int* groupOf = groupMaps[(int) linkMode].get();
+        auto* gains = activeEnvelopes.get();   // peak y luego ganancia de cada grupo
+        const SampleType* const* detector = keyChannels != nullptr ? keyChannels : channels;
+        const bool filterKey = keyFilter.isActive();
+        SampleType maxGR = SampleType (0);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            // 1. Peak por grupo (máximo de sus canales)
+            for (int g = 0; g < numGroups; ++g)
+                gains[g] = SampleType (0);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const SampleType key   = filterKey ? keyFilter.processSample (ch, detector[ch][sample]) : detector[ch][sample];
+                const SampleType level = detectorMode == DetectorMode::truePeak ? truePeak.processSample (ch, key) : std::abs (key);
+                gains[groupOf[ch]] = juce::jmax (gains[groupOf[ch]], level);
+            }
+
+            if (detectorMode == DetectorMode::rms)
+                for (int g = 0; g < numGroups; ++g)
+                    gains[g] = rmsWindows[(size_t) g].push (gains[g]);
+
+            SampleType threshold, slope;
+            gainComputer.getNextThresholdAndSlope (threshold, slope);
+
+            for (int g = 0; g < numGroups; ++g)
+            {
+                // 1b. Lookahead
+                const SampleType peakLevel = lookaheadSamples > 0 ? peakWindows[(size_t) g].push (gains[g]) : gains[g];
+
+                // 2-4. dB, gain computer y balística
+                envelopes[g] = gainComputer.processSampleReference (peakLevel, envelopes[g], holdCounters[g], threshold, slope);
+                maxGR = juce::jmin (maxGR, envelopes[g]);
+
+                // 5. Ganancia lineal del grupo
+                gains[g] = juce::Decibels::decibelsToGain (envelopes[g], GainComputer::minusInfinityDb());
+            }
+
+            // 6. Aplicar a cada canal la ganancia de su grupo
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                SampleType input = channels[ch][sample];
+
+                if (lookaheadSamples > 0)
+                {
+                    auto& delay = lookaheadDelays[(size_t) ch];
+                    input = delay.processSample (0, input);
+                    delay.advance();
+                }
+
+                channels[ch][sample] = input * gains[groupOf[ch]];
+            }
+        }
+
+        return maxGR;
+    }
+
+private:
+    //==============================================================================
+    enum Role { frontRole = 0, lfeRole, surroundRole, heightRole, otherRole, numRoles };
+
+    static Role getRole (juce::AudioChannelSet::ChannelType type) noexcept
+    {
+        using CS = juce::AudioChannelSet;
+
+        switch (type)
+        {
+            case CS::left:  case CS::right:  case CS::centre:
+            case CS::leftCentre:  case CS::rightCentre:
+            case CS::wideLeft:  case CS::wideRight:
+                return frontRole;
+
+            case CS::LFE:  case CS::LFE2:
+                return lfeRole;
+
+            case CS::leftSurround:  case CS::rightSurround:  case CS::centreSurround:
+            case CS::leftSurroundSide:  case CS::rightSurroundSide:
+            case CS::leftSurroundRear:  case CS::rightSurroundRear:
+                return surroundRole;
+
+            case CS::topMiddle:
+            case CS::topFrontLeft:  case CS::topFrontCentre:  case CS::topFrontRight:
+            case CS::topRearLeft:   case CS::topRearCentre:   case CS::topRearRight:
+            case CS::topSideLeft:   case CS::topSideRight:
+            case CS::bottomFrontLeft:  case CS::bottomFrontCentre:  case CS::bottomFrontRight:
+            case CS::bottomSideLeft:   case CS::bottomSideRight:
+            case CS::bottomRearLeft:   case CS::bottomRearCentre:   case CS::bottomRearRight:
+                return heightRole;
+
+            default:
+                return otherRole;
+        }
+    }
+
+    enum PathState : juce::uint8 { openPath = 0, closedPath, fullPath };
+
+    SampleType* levelPlane (int group) noexcept  { return levelPlanes.get() + group * subBlockSize; }
+    SampleType* gainPlane (int group) noexcept   { return gainPlanes.get()  + group * subBlockSize; }
+
+    //==============================================================================
+    // 1 con filtro de key: entrelazar [muestra][canal], filtrar todos los canales
+    // a la vez (un carril por canal) y llevar |key| al plano de su grupo
+    void detectFilteredKeyLevel (const SampleType* const* key, const int* groupOf, int offset, int numSamples) noexcept
+    {
+        const bool truePeakMode = detectorMode == DetectorMode::truePeak;
+        auto* frames = interleaved.get();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* source = key[ch] + offset;
+
+            for (int i = 0; i < numSamples; ++i)
+                frames[i * numChannels + ch] = source[i];
+        }
+
+        keyFilter.processInterleaved (frames, numSamples, numChannels);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const int g = groupOf[ch];
+            auto* level = levelPlane (g);
+
+            if (truePeakMode)
+            {
+                // True peak: el FIR polifásico necesita el canal contiguo
+                auto* rectified = groupSeen[g] == 0 ? level : scratch.get();
+
+                for (int i = 0; i < numSamples; ++i)
+                    rectified[i] = frames[i * numChannels + ch];
+
+                truePeak.process (ch, rectified, rectified, numSamples);
+
+                if (groupSeen[g] != 0)
+                    juce::FloatVectorOperations::max (level, level, rectified, numSamples);
+
+                groupSeen[g] = 1;
+            }
+            else if (groupSeen[g] == 0)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    level[i] = std::abs (frames[i * numChannels + ch]);
+
+                groupSeen[g] = 1;
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    level[i] = juce::jmax (level[i], std::abs (frames[i * numChannels + ch]));
+            }
+        }
+    }
+
+    //==============================================================================
+    SampleType processChunk (SampleType* const* channels, const SampleType* const* keyChannels,
+                             int offset, int numSamples) noexcept
+    {
+        const int* groupOf = groupMaps[(int) linkMode].get();
+        const SampleType* const* detector = keyChannels != nullptr ? keyChannels : channels;
+
+        // 1. Detección: |x| de cada canal y máximo dentro de su grupo
+        for (int g = 0; g < numGroups; ++g)
+            groupSeen[g] = 0;
+
+        if (keyFilter.isActive())
+        {
+            detectFilteredKeyLevel (detector, groupOf, offset, numSamples);
+        }
+        else
+        {
+            const bool truePeakMode = detectorMode == DetectorMode::truePeak;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const int g = groupOf[ch];
+                auto* level = levelPlane (g);
+                auto* rectified = groupSeen[g] == 0 ? level : scratch.get();
+
+                if (truePeakMode)
+                    truePeak.process (ch, detector[ch] + offset, rectified, numSamples);
+                else
+                    juce::FloatVectorOperations::abs (rectified, detector[ch] + offset, numSamples);
+
+                if (groupSeen[g] != 0)
+                    juce::FloatVectorOperations::max (level, level, rectified, numSamples);
+
+                groupSeen[g] = 1;
+            }
+        }
+
+        // 1a. RMS deslizante por grupo (O(1) por muestra)
+        if (detectorMode == DetectorMode::rms)
+            for (int g = 0; g < numGroups; ++g)
+                rmsWindows[(size_t) g].process (levelPlane (g), numSamples);
+
+        // 1b. Lookahead: máximo deslizante por grupo
+        const bool useLookahead = lookaheadSamples > 0;
+
+        if (useLookahead)
+            for (int g = 0; g < numGroups; ++g)
+                peakWindows[(size_t) g].process (levelPlane (g), numSamples);
+
+        // 1c. Rutas rápidas por grupo; los que no están asentados pasan a la lista activa
+        const bool smoothing = gainComputer.isSmoothing();
+        SampleType maxGR = SampleType (0);
+        int numActive = 0;
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            if (! smoothing)
+            {
+                const auto levelRange = juce::FloatVectorOperations::findMinAndMax (levelPlane (g), numSamples);
+
+                if (gainComputer.isSettledOpen (envelopes[g], levelRange.getStart(), holdCounters[g]))
+                {
+                    envelopes[g]    = SampleType (0);
+                    holdCounters[g] = gainComputer.getHoldReloadSamples();
+                    groupPaths[g] = openPath;
+                    ++lastPathCounts.open;
+                    continue;
+                }
+
+                if (gainComputer.isSettledClosed (envelopes[g], levelRange.getEnd(), holdCounters[g]))
+                {
+                    envelopes[g]  = gainComputer.getClosedTargetDb();
+                    groupPaths[g] = closedPath;
+                    maxGR = juce::jmin (maxGR, envelopes[g]);
+                    ++lastPathCounts.closed;
+                    continue;
+                }
+            }
+
+            groupPaths[g] = fullPath;
+            activeGroups[numActive++] = g;
+            ++lastPathCounts.full;
+        }
+
+        if (numActive > 0)
+        {
+            // 2-3. dB y gain computer por grupo (las rampas se avanzan una sola vez)
+            const SampleType* thresholds = nullptr;
+            const SampleType* slopes     = nullptr;
+
+            if (smoothing)
+            {
+                gainComputer.fillRamps (thresholdRamp.get(), slopeRamp.get(), numSamples);
+                thresholds = thresholdRamp.get();
+                slopes     = slopeRamp.get();
+            }
+
+            for (int a = 0; a < numActive; ++a)
+                gainComputer.computeTargetGain (levelPlane (activeGroups[a]), numSamples, thresholds, slopes);
+
+            // 3b-4. Hold/histéresis y balística: con un solo grupo activo, en su
+            //      plano; con varios, en el buffer entrelazado, vectorizada entre grupos
+            if (numActive == 1)
+                maxGR = juce::jmin (maxGR, gainComputer.applyBallistics (levelPlane (activeGroups[0]), numSamples,
+                                                                         envelopes[activeGroups[0]],
+                                                                         holdCounters[activeGroups[0]]));
+            else
+                maxGR = juce::jmin (maxGR, applyBallisticsAcrossGroups (numActive, numSamples));
+
+            // 5. GR suavizada -> ganancia lineal
+            for (int a = 0; a < numActive; ++a)
+                gainComputer.decibelsToGain (gainPlane (activeGroups[a]), levelPlane (activeGroups[a]), numSamples);
+        }
+
+        // 6. Retrasar el audio y aplicar a cada canal la ganancia de su grupo
+        const SampleType closedGain = gainComputer.getClosedGain();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (useLookahead)
+                lookaheadDelays[(size_t) ch].process (channels + ch, offset, numSamples);
+
+            auto* data  = channels[ch] + offset;
+            const int g = groupOf[ch];
+
+            if (groupPaths[g] == fullPath)
+                juce::FloatVectorOperations::multiply (data, gainPlane (g), numSamples);
+            else if (groupPaths[g] == closedPath)
+            {
+                if (closedGain > SampleType (0))
+                    juce::FloatVectorOperations::multiply (data, closedGain, numSamples);
+                else
+                    juce::FloatVectorOperations::clear (data, numSamples);
+            }
+        }
+
+        return maxGR;
+    }
+
+    // Transpone los planos activos a [muestra][grupo], aplica la balística de
+    // todos los grupos a la vez y devuelve el resultado a los planos
+    SampleType applyBallisticsAcrossGroups (int numActive, int numSamples) noexcept
+    {
+        auto* frames = interleaved.get();
+
+        for (int a = 0; a < numActive; ++a)
+        {
+            const auto* level = levelPlane (activeGroups[a]);
+
+            for (int i = 0; i < numSamples; ++i)
+                frames[i * numActive + a] = level[i];
+
+            activeEnvelopes[a] = envelopes[activeGroups[a]];
+            activeHolds[a]     = holdCounters[activeGroups[a]];
+        }
+
+        gainComputer.applyBallisticsInterleaved (frames, numSamples, activeEnvelopes.get(), activeHolds.get(), numActive);
+
+        for (int a = 0; a < numActive; ++a)
+        {
+            auto* level = levelPlane (activeGroups[a]);
+
+            for (int i = 0; i < numSamples; ++i)
+                level[i] = frames[i * numActive + a];
+
+            envelopes[activeGroups[a]]    = activeEnvelopes[a];
+            holdCounters[activeGroups[a]] = activeHolds[a];
+        }
+
+        return juce::jmin (SampleType (0), juce::FloatVectorOperations::findMinimum (frames, numActive * numSamples));
+    }
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    int numChannels   = 0;
+    int subBlockSize  = 0;
+
+    // --- Grupos de detección (los tres modos, calculados en prepare) ---
+    juce::HeapBlock<int> groupMaps[numLinkModes];
+    int numGroupsPerMode[numLinkModes] = { 1, 1, 1 };
+    GateLinkMode linkMode = GateLinkMode::linked;
+    int numGroups = 1;
+
+    // --- Gain computer compartido por todos los grupos ---
+    GainComputer gainComputer;
+    PathCounts lastPathCounts;
+
+    // --- Estado por grupo (estructura de arrays) ---
+    juce::HeapBlock<SampleType> envelopes;        // GR suavizada de cada grupo (dB)
+    juce::HeapBlock<SampleType> activeEnvelopes;  // envolventes de los grupos activos, contiguas
+    juce::HeapBlock<int> holdCounters;            // muestras de hold restantes de cada grupo
+    juce::HeapBlock<int> activeHolds;             // hold de los grupos activos, contiguo
+    juce::HeapBlock<int> activeGroups;            // grupos por la ruta completa en este sub-bloque
+    juce::HeapBlock<juce::uint8> groupPaths;      // PathState de cada grupo
+    juce::HeapBlock<juce::uint8> groupSeen;
+
+    // --- Buffers de trabajo (reservados en prepare) ---
+    juce::HeapBlock<SampleType> levelPlanes;   // [grupo][muestra]: nivel / GR objetivo / envolvente
+    juce::HeapBlock<SampleType> gainPlanes;    // [grupo][muestra]: ganancia lineal
+    juce::HeapBlock<SampleType> interleaved;   // [muestra][grupo activo]: balística
+    juce::HeapBlock<SampleType> scratch;
+    juce::HeapBlock<SampleType> thresholdRamp, slopeRamp;
+
+    // --- Lookahead ---
+    std::vector<SlidingWindowMax<SampleType>> peakWindows;      // uno por grupo
+    std::vector<LookaheadDelay<SampleType, 1>> lookaheadDelays; // uno por canal
+    int lookaheadSamples = 0;
+
+    // --- Filtro de la señal de detección (un carril por canal) ---
+    KeyFilter<SampleType> keyFilter;
+
+    // --- Modo del detector ---
+    DetectorMode detectorMode = DetectorMode::peak;
+    TruePeakDetector<SampleType> truePeak;                // un estado por canal
+    std::vector<RunningRms<SampleType>> rmsWindows;       // uno por grupo
+};
@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    NoiseFloorAnalyser.h
+
+    Estimación en streaming del suelo de ruido para el umbral automático
+    (AUTO_THRESHOLD) y el análisis por lotes de SilentRoomBatch.
+
+    La señal se trocea en ventanas de 10 ms y el pico de cada ventana (la
+    misma escala que ve el detector peak) se acumula en un histograma de
+    dB de bins fijos: 0.5 dB de -120 a 0 dB. El suelo de ruido es un
+    cuantil bajo de ese histograma (por defecto el 10 %: los tramos en los
+    que la fuente calla). Las ventanas de silencio digital (< -120 dB) no
+    cuentan, así que las colas de silencio de una toma no hunden el suelo.
+
+    Memoria constante (240 contadores) y coste constante: un min/max
+    vectorizado por canal y bloque, un incremento por ventana y un recorrido
+    del histograma por consulta, sea cual sea la duración analizada.
+
+    Con setMemorySeconds() el histograma olvida: al llegar a esa cantidad de
+    ventanas todos los contadores se dividen entre dos (amortizado O(1)), de
+    modo que la estimación sigue a la sala si cambia durante la sesión. Con
+    0 se conserva todo (análisis de ficheros completos).
+
+    Toda la memoria es interna; prepare() y reset() no reservan.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class NoiseFloorAnalyser
+{
+public:
+    static constexpr float minDb      = -120.0f;
+    static constexpr float maxDb      = 0.0f;
+    static constexpr float binWidthDb = 0.5f;
+    static constexpr int   numBins    = (int) ((maxDb - minDb) / binWidthDb);
+
+    static constexpr double windowMs = 10.0;
+    static constexpr float defaultQuantile = 0.1f;
+
+    // Mínimo de ventanas analizadas para dar una estimación (1 s)
+    static constexpr juce::uint32 minWindowsForEstimate = 100;
+
+    //==============================================================================
+    void prepare (double sampleRate) noexcept
+    {
+        windowLength = juce::jmax (1, juce::roundToInt (sampleRate * windowMs * 0.001));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        bins.fill (0);
+        numWindows   = 0;
+        windowPeak   = 0.0;
+        windowFilled = 0;
+    }
+
+    // 0 = sin olvido; si no, ventanas que se acumulan antes de dividir el histograma
+    void setMemorySeconds (double seconds) noexcept
+    {
+        maxWindows = seconds > 0.0 ? (juce::uint32) juce::jmax (4.0 * minWindowsForEstimate, seconds * 1000.0 / windowMs) : 0;
+    }
+
+    //==============================================================================
+    // Analiza un bloque (todos los canales se enlazan: pico del bus).
+    // Devuelve el número de ventanas completadas en este bloque.
+    template <typename SampleType>
+    int process (const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        int completed = 0;
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int n = juce::jmin (numSamples - start, windowLength - windowFilled);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto range = juce::FloatVectorOperations::findMinAndMax (channels[ch] + start, n);
+                windowPeak = juce::jmax (windowPeak, (double) -range.getStart(), (double) range.getEnd());
+            }
+
+            start        += n;
+            windowFilled += n;
+
+            if (windowFilled == windowLength)
+            {
+                addWindow (windowPeak);
+                windowPeak   = 0.0;
+                windowFilled = 0;
+                ++completed;
+            }
+        }
+
+        return completed;
+    }
+
+    //==============================================================================
+    bool hasEstimate() const noexcept   { return numWindows >= minWindowsForEstimate; }
+    juce::uint32 getNumWindows() const noexcept  { return numWindows; }
+
+    // Nivel (dB de pico por ventana) por debajo del cual queda la fracción
+    // quantile de las ventanas, interpolado dentro del bin. minDb si no hay datos.
+    float getQuantileDb (float quantile = defaultQuantile) const noexcept
+    {
+        if (numWindows == 0)
+            return minDb;
+
+        const double target = juce::jlimit (0.0, 1.0, (double) quantile) * (double) numWindows;
+        double accumulated = 0.0;
+
+        for (int b = 0; b < numBins; ++b)
+        {
+            const double count = (double) bins[(size_t) b];
+
+            if (count > 0.0 && accumulated + count >= target)
+                return minDb + binWidthDb * ((float) b + (float) ((target - accumulated) / count));
+
+            accumulated += count;
+        }
+
+        return maxDb;
+    }
+
+private:
+    void addWindow (double peak) noexcept
+    {
+        const auto db = (float) juce::Decibels::gainToDecibels (peak, (double) minDb - 1.0);
+
+        // Silencio digital: no es ruido de la sala
+        if (db < minDb)
+            return;
+
+        const int bin = juce::jmin (numBins - 1, (int) ((db - minDb) / binWidthDb));
+        ++bins[(size_t) bin];
+
+        if (++numWindows == maxWindows)
+        {
+            numWindows = 0;
+
+            for (auto& count : bins)
+            {
+                count >>= 1;
+                numWindows += count;
+            }
+        }
+    }
+
+    std::array<juce::uint32, (size_t) numBins> bins {};
+    juce::uint32 numWindows = 0;
+    juce::uint32 maxWindows = 0;
+
+    int windowLength = 480;
+    int windowFilled = 0;
+    double windowPeak = 0.0;
+};
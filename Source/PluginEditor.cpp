@@ -34,12 +34,96 @@ SilentRoomAudioProcessorEditor::SilentRoomAudioProcessorEditor (SilentRoomAudioP
     setupRotarySlider (ratioSlider,     ratioLabel,     "Ratio",     this);
     setupRotarySlider (attackSlider,    attackLabel,     "Attack",    this);
     setupRotarySlider (releaseSlider,   releaseLabel,    "Release",   this);
+    setupRotarySlider (lookaheadSlider, lookaheadLabel,  "Lookahead", this);
 
     // --- 2. Sufijos de unidad ---
     thresholdSlider.setTextValueSuffix (" dB");
     ratioSlider.setTextValueSuffix     (":1");
     attackSlider.setTextValueSuffix    (" ms");
     releaseSlider.setTextValueSuffix   (" ms");
+    lookaheadSlider.setTextValueSuffix (" ms");
+
+    // --- 2b. Selector de enlace (opciones antes del attachment) ---
+    if (auto* linkChoice = dynamic_cast<juce::AudioParameterChoice*> (audioProcessor.apvts.getParameter ("LINK")))
+        linkBox.addItemList (linkChoice->choices, 1);
+
+    linkBox.setTooltip ("Enlace de canales: un detector para todo el bus, uno por canal o uno por grupo");
+    addAndMakeVisible (linkBox);
+
+    // --- 2c. Detección: key externa y filtro de key ---
+    sidechainButton.setTooltip ("Detectar sobre el bus de sidechain en lugar de la entrada");
+    addAndMakeVisible (sidechainButton);
+
+    if (auto* keyFilterChoice = dynamic_cast<juce::AudioParameterChoice*> (audioProcessor.apvts.getParameter ("KEY_FILTER")))
+        keyFilterBox.addItemList (keyFilterChoice->choices, 1);
+
+    keyFilterBox.setTooltip ("Filtro de la señal de detección (el audio no se filtra)");
+    addAndMakeVisible (keyFilterBox);
+
+    keyFreqSlider.setSliderStyle (juce::Slider::LinearBar);
+    keyFreqSlider.setTextValueSuffix (" Hz");
+    addAndMakeVisible (keyFreqSlider);
+
+    if (auto* detectorChoice = dynamic_cast<juce::AudioParameterChoice*> (audioProcessor.apvts.getParameter ("DETECTOR")))
+        detectorBox.addItemList (detectorChoice->choices, 1);
+
+    detectorBox.setTooltip ("Detector de nivel: peak, RMS deslizante o true peak (x4)");
+    addAndMakeVisible (detectorBox);
+
+    rmsWindowSlider.setSliderStyle (juce::Slider::LinearBar);
+    rmsWindowSlider.setTextValueSuffix (" ms RMS");
+    addAndMakeVisible (rmsWindowSlider);
+
+    // --- 2d. Multibanda ---
+    if (auto* bandsChoice = dynamic_cast<juce::AudioParameterChoice*> (audioProcessor.apvts.getParameter ("BANDS")))
+        bandsBox.addItemList (bandsChoice->choices, 1);
+
+    bandsBox.setTooltip ("Número de bandas: cada una con su propio umbral, ratio y envolvente");
+    addAndMakeVisible (bandsBox);
+
+    for (auto& slider : crossoverSliders)
+    {
+        slider.setSliderStyle (juce::Slider::LinearBar);
+        slider.setTextValueSuffix (" Hz");
+        addAndMakeVisible (slider);
+    }
+
+    for (int b = 0; b < maxBands; ++b)
+    {
+        bandThresholdSliders[b].setSliderStyle (juce::Slider::LinearBar);
+        bandThresholdSliders[b].setTextValueSuffix (" dB");
+        addAndMakeVisible (bandThresholdSliders[b]);
+
+        bandRatioSliders[b].setSliderStyle (juce::Slider::LinearBar);
+        bandRatioSliders[b].setTextValueSuffix (":1");
+        addAndMakeVisible (bandRatioSliders[b]);
+    }
+
+    // --- 2e. Modo espectral ---
+    if (auto* modeChoice = dynamic_cast<juce::AudioParameterChoice*> (audioProcessor.apvts.getParameter ("MODE")))
+        modeBox.addItemList (modeChoice->choices, 1);
+
+    modeBox.setTooltip ("Gate: puerta de dominio temporal. Spectral: puerta por bin contra el perfil de ruido");
+    addAndMakeVisible (modeBox);
+
+    learnButton.setTooltip ("Aprender el perfil de ruido (activar durante un tramo solo con ruido)");
+    addAndMakeVisible (learnButton);
+
+    spectralOffsetSlider.setSliderStyle (juce::Slider::LinearBar);
+    spectralOffsetSlider.setTextValueSuffix (" dB sobre el ruido");
+    addAndMakeVisible (spectralOffsetSlider);
+
+    // --- 2f. Umbral automático ---
+    autoThresholdButton.setTooltip ("El umbral sigue al suelo de ruido estimado más el margen");
+    addAndMakeVisible (autoThresholdButton);
+
+    autoMarginSlider.setSliderStyle (juce::Slider::LinearBar);
+    autoMarginSlider.setTextValueSuffix (" dB de margen");
+    addAndMakeVisible (autoMarginSlider);
+
+    noiseFloorLabel.setFont (juce::FontOptions (12.0f));
+    noiseFloorLabel.setColour (juce::Label::textColourId, juce::Colour (0xffccccee));
+    addAndMakeVisible (noiseFloorLabel);
 
     // --- 3. APVTS Attachments (DESPUÉS de configurar los sliders) ---
     thresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
@@ -50,12 +134,89 @@ SilentRoomAudioProcessorEditor::SilentRoomAudioProcessorEditor (SilentRoomAudioP
         audioProcessor.apvts, "ATTACK", attackSlider);
     releaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
         audioProcessor.apvts, "RELEASE", releaseSlider);
+    lookaheadAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "LOOKAHEAD", lookaheadSlider);
+    linkAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+        audioProcessor.apvts, "LINK", linkBox);
+    sidechainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (
+        audioProcessor.apvts, "SIDECHAIN", sidechainButton);
+    keyFilterAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+        audioProcessor.apvts, "KEY_FILTER", keyFilterBox);
+    keyFreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "KEY_FREQ", keyFreqSlider);
+    detectorAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+        audioProcessor.apvts, "DETECTOR", detectorBox);
+    rmsWindowAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "RMS_WINDOW", rmsWindowSlider);
+    bandsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+        audioProcessor.apvts, "BANDS", bandsBox);
+
+    for (int k = 0; k < maxBands - 1; ++k)
+        crossoverAttachments[k] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+            audioProcessor.apvts, "XOVER_" + juce::String (k + 1), crossoverSliders[k]);
+
+    for (int b = 0; b < maxBands; ++b)
+    {
+        bandThresholdAttachments[b] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+            audioProcessor.apvts, "THRESHOLD_B" + juce::String (b + 1), bandThresholdSliders[b]);
+        bandRatioAttachments[b] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+            audioProcessor.apvts, "RATIO_B" + juce::String (b + 1), bandRatioSliders[b]);
+    }
+
+    modeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+        audioProcessor.apvts, "MODE", modeBox);
+    learnAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (
+        audioProcessor.apvts, "LEARN", learnButton);
+    spectralOffsetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "SPECTRAL_OFFSET", spectralOffsetSlider);
+    autoThresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (
+        audioProcessor.apvts, "AUTO_THRESHOLD", autoThresholdButton);
+    autoMarginAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "AUTO_MARGIN", autoMarginSlider);
+
+    // --- 2g. Hold e histéresis ---
+    holdSlider.setSliderStyle (juce::Slider::LinearBar);
+    holdSlider.setTextValueSuffix (" ms hold");
+    holdSlider.setTooltip ("Tiempo que la puerta sigue abierta tras caer la señal bajo el umbral");
+    addAndMakeVisible (holdSlider);
+
+    hysteresisSlider.setSliderStyle (juce::Slider::LinearBar);
+    hysteresisSlider.setTextValueSuffix (" dB histéresis");
+    hysteresisSlider.setTooltip ("Dentro de la puerta abierta, cierra solo por debajo de umbral - histéresis");
+    addAndMakeVisible (hysteresisSlider);
 
-    // --- 4. Timer a 60 FPS para el medidor de GR ---
-    startTimerHz (60);
+    holdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "HOLD", holdSlider);
+    hysteresisAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "HYSTERESIS", hysteresisSlider);
+
+    // --- 2h. Rodilla y atenuación máxima ---
+    kneeSlider.setSliderStyle (juce::Slider::LinearBar);
+    kneeSlider.setTextValueSuffix (" dB knee");
+    kneeSlider.setTooltip ("Ancho de la transición suave alrededor del umbral (0 = rodilla dura)");
+    addAndMakeVisible (kneeSlider);
+
+    rangeSlider.setSliderStyle (juce::Slider::LinearBar);
+    rangeSlider.setTextValueSuffix (" dB range");
+    rangeSlider.setTooltip ("Atenuación máxima de la puerta cerrada (100 = silencio)");
+    addAndMakeVisible (rangeSlider);
+
+    kneeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "KNEE", kneeSlider);
+    rangeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (
+        audioProcessor.apvts, "RANGE", rangeSlider);
+
+    // --- 4. Timer a 60 FPS para el medidor de GR y el historial ---
+    // Lo acumulado con el editor cerrado es antiguo: empezar desde ahora
+    audioProcessor.telemetry.discardAll();
+    startTimerHz (activeRefreshHz);
 
     // --- 5. Tamaño de ventana ---
-    setSize (500, 400);
+    // Fondo opaco (capa cacheada): el host no repinta lo que hay detrás
+    setOpaque (true);
+    setSize (500, 720);
+    updateDspText();
+    updateNoiseFloorText();
 }
 
 SilentRoomAudioProcessorEditor::~SilentRoomAudioProcessorEditor()
@@ -66,53 +227,196 @@ SilentRoomAudioProcessorEditor::~SilentRoomAudioProcessorEditor()
 //==============================================================================
 void SilentRoomAudioProcessorEditor::timerCallback()
 {
-    // Lectura atómica desde el procesador
-    const float newGR = audioProcessor.gainReduction.load (std::memory_order_relaxed);
+    HistoryColumn column;
+
+    // Sin bloques nuevos (transporte parado) el historial no avanza
+    if (drainTelemetry (column))
+    {
+        pushHistoryColumn (column);
+
+        // El medidor sigue la GR más profunda del intervalo: ningún pico se pierde
+        targetGR  = column.minGainReductionDb;
+        idleTicks = 0;
+
+        if (getTimerInterval() != 1000 / activeRefreshHz)
+            startTimerHz (activeRefreshHz);
+    }
+    else if (++idleTicks == idleAfterTicks)
+    {
+        // Medio segundo sin audio: refresco lento hasta el próximo bloque
+        startTimerHz (idleRefreshHz);
+    }
+
+    // Suavizado exponencial (80% valor anterior, 20% valor nuevo); al
+    // llegar al destino se fija para que el medidor deje de repintarse
+    currentGR = currentGR * 0.8f + targetGR * 0.2f;
+
+    if (std::abs (currentGR - targetGR) < 0.01f)
+        currentGR = targetGR;
 
-    // Suavizado exponencial (80% valor anterior, 20% valor nuevo)
-    currentGR = currentGR * 0.8f + newGR * 0.2f;
+    updateMeter();
 
-    repaint();
+    if (++dspTextTicks >= dspTextRefreshTicks)
+    {
+        dspTextTicks = 0;
+        updateDspText();
+        updateNoiseFloorText();
+    }
 }
 
-//==============================================================================
-void SilentRoomAudioProcessorEditor::paint (juce::Graphics& g)
+// Vacía el FIFO de telemetría por lotes y resume los bloques en una columna.
+// Devuelve false si no había ningún bloque.
+bool SilentRoomAudioProcessorEditor::drainTelemetry (HistoryColumn& column)
 {
-    // --- Fondo oscuro ---
-    g.fillAll (juce::Colour (0xff1a1a2e));
+    int numRecords = 0;
+    float minGR = 0.0f, maxGR = std::numeric_limits<float>::lowest();
+    float inputPeak = 0.0f, outputPeak = 0.0f;
+    auto state = GateState::open;
 
-    // --- Título ---
-    g.setColour (juce::Colour (0xffe0e0ff));
-    g.setFont (juce::FontOptions (20.0f));
-    g.drawText ("SilentRoom – Noise Gate", getLocalBounds().removeFromTop (30),
-                juce::Justification::centred, true);
+    for (int batchSize; (batchSize = audioProcessor.telemetry.pop (telemetryBatch.data(), (int) telemetryBatch.size())) > 0;)
+    {
+        for (int i = 0; i < batchSize; ++i)
+        {
+            const auto& record = telemetryBatch[(size_t) i];
+            minGR      = juce::jmin (minGR, record.minGainReductionDb);
+            maxGR      = juce::jmax (maxGR, record.maxGainReductionDb);
+            inputPeak  = juce::jmax (inputPeak, record.inputPeak);
+            outputPeak = juce::jmax (outputPeak, record.outputPeak);
 
-    // --- Medidor de Gain Reduction ---
-    // Área del medidor: franja inferior
-    const int meterHeight = 30;
-    const int meterMargin = 20;
-    auto meterArea = getLocalBounds().removeFromBottom (meterHeight + meterMargin)
-                         .reduced (meterMargin, 0)
-                         .removeFromTop (meterHeight);
+            // Abierta o cerrada solo si todos los bloques lo están
+            if (numRecords == 0)
+                state = record.state;
+            else if (record.state != state)
+                state = GateState::moving;
 
-    // Fondo del medidor
-    g.setColour (juce::Colour (0xff0d0d1a));
-    g.fillRoundedRectangle (meterArea.toFloat(), 4.0f);
+            ++numRecords;
+        }
+    }
 
-    // Borde
-    g.setColour (juce::Colour (0xff3a3a5c));
-    g.drawRoundedRectangle (meterArea.toFloat(), 4.0f, 1.0f);
+    if (numRecords == 0)
+        return false;
+
+    column.minGainReductionDb = minGR;
+    column.maxGainReductionDb = juce::jmax (minGR, maxGR);
+    column.inputPeakDb  = juce::Decibels::gainToDecibels (inputPeak);
+    column.outputPeakDb = juce::Decibels::gainToDecibels (outputPeak);
+    column.state = state;
+    return true;
+}
+
+//==============================================================================
+// --- Repintado por regiones ---
+// Cada parte dinámica guarda lo último que pintó; solo se invalida su
+// rectángulo cuando lo visible cambia.
 
+void SilentRoomAudioProcessorEditor::updateMeter()
+{
     // Barra de GR: currentGR va de 0 (sin reducción) a -60 (máxima reducción)
     // Normalizamos a 0..1 donde 0 = sin reducción, 1 = -60 dB de reducción
     const float grNorm = juce::jlimit (0.0f, 1.0f, -currentGR / 60.0f);
+    const int barWidth = grNorm > 0.001f ? juce::roundToInt ((float) (meterBounds.getWidth() - 4) * grNorm) : 0;
+
+    auto text = "GR: " + juce::String (currentGR, 1) + " dB";
+
+    if (barWidth != meterBarWidth || text != meterText)
+    {
+        meterBarWidth = barWidth;
+        meterText = std::move (text);
+        repaint (meterBounds);
+    }
+}
+
+void SilentRoomAudioProcessorEditor::updateDspText()
+{
+    // Coste de DSP por bloque (lectura sin bloqueo de las estadísticas)
+    const auto timing = audioProcessor.timingStats.getSnapshot();
+
+    juce::String text = "DSP: media " + juce::String (timing.meanMicros, 1) + " us"
+                      + "  p99 " + juce::String (timing.getPercentileMicros (0.99), 1) + " us"
+                      + "  peor " + juce::String (timing.worstMicros, 1) + " us"
+                      + "  fuera de plazo " + juce::String ((juce::int64) timing.deadlineMisses);
+
+   #if SILENTROOM_REALTIME_GUARD
+    text << "  RT: " << (juce::int64) RealtimeGuard::getNumViolations();
+   #endif
+
+    if (text != dspText)
+    {
+        dspText = std::move (text);
+        repaint (dspTextBounds);
+    }
+}
+
+// Suelo de ruido estimado y umbral resultante (el Label solo se repinta si
+// el texto cambia)
+void SilentRoomAudioProcessorEditor::updateNoiseFloorText()
+{
+    float noiseFloorDb = 0.0f, thresholdDb = 0.0f;
+
+    if (! audioProcessor.getNoiseFloorEstimate (noiseFloorDb, thresholdDb))
+    {
+        noiseFloorLabel.setText ("Ruido: analizando...", juce::dontSendNotification);
+        return;
+    }
+
+    noiseFloorLabel.setText ("Ruido " + juce::String (noiseFloorDb, 1) + " dB -> umbral "
+                                 + juce::String (thresholdDb, 1) + " dB"
+                                 + (autoThresholdButton.getToggleState() ? "" : " (sugerido)"),
+                             juce::dontSendNotification);
+}
+
+// Guarda la columna, la dibuja en su píxel del buffer circular y solo
+// invalida el área del historial
+void SilentRoomAudioProcessorEditor::pushHistoryColumn (const HistoryColumn& column)
+{
+    history[(size_t) historyWritePosition] = column;
+
+    if (historyImage.isValid())
+        renderHistoryColumn (historyWritePosition);
+
+    historyWritePosition = (historyWritePosition + 1) % historyLength;
+    repaint (historyBounds);
+}
+
+//==============================================================================
+void SilentRoomAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    // Las capas cacheadas se generan a la resolución física del contexto
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (! backgroundImage.isValid() || scale != imageScale)
+    {
+        imageScale = scale;
+        renderBackground();
+        renderHistory();
+    }
+
+    g.drawImage (backgroundImage, getLocalBounds().toFloat(), juce::RectanglePlacement::stretchToFit);
+
+    if (g.clipRegionIntersects (meterBounds))
+        paintMeter (g);
+
+    if (g.clipRegionIntersects (dspTextBounds))
+    {
+        g.setColour (juce::Colour (0xff8888aa));
+        g.setFont (juce::FontOptions (11.0f));
+        g.drawText (dspText, dspTextBounds, juce::Justification::centredLeft, true);
+    }
+
+    if (g.clipRegionIntersects (historyBounds))
+        paintHistory (g);
+}
 
-    if (grNorm > 0.001f)
+void SilentRoomAudioProcessorEditor::paintMeter (juce::Graphics& g) const
+{
+    if (meterBarWidth > 0)
     {
-        auto barArea = meterArea.toFloat().reduced (2.0f);
-        barArea.setWidth (barArea.getWidth() * grNorm);
+        auto barArea = meterBounds.toFloat().reduced (2.0f);
+        barArea.setWidth ((float) meterBarWidth);
 
         // Gradiente de verde a rojo según la intensidad
+        const float grNorm = barArea.getWidth() / ((float) meterBounds.getWidth() - 4.0f);
+
         auto barColour = juce::Colour::fromHSV (
             0.33f * (1.0f - grNorm),  // Hue: verde(0.33) → rojo(0.0)
             0.8f,                      // Saturación
@@ -127,9 +431,116 @@ void SilentRoomAudioProcessorEditor::paint (juce::Graphics& g)
     // Texto del medidor
     g.setColour (juce::Colour (0xffccccee));
     g.setFont (juce::FontOptions (12.0f));
+    g.drawText (meterText, meterBounds, juce::Justification::centred, true);
+}
+
+// Columnas de la más antigua (izquierda) a la más reciente (derecha): el
+// buffer circular de historyImage se copia en dos tramos, sin redibujar
+void SilentRoomAudioProcessorEditor::paintHistory (juce::Graphics& g) const
+{
+    const auto plot = historyBounds.reduced (2);
+    const int oldestCount = historyLength - historyWritePosition;
+    const int splitX = plot.getX() + juce::roundToInt ((float) plot.getWidth() * (float) oldestCount / (float) historyLength);
+    const int imageHeight = historyImage.getHeight();
+
+    // Vecino más cercano: cada columna conserva sus bordes al escalar
+    g.setImageResamplingQuality (juce::Graphics::lowResamplingQuality);
+
+    g.drawImage (historyImage, plot.getX(), plot.getY(), splitX - plot.getX(), plot.getHeight(),
+                 historyWritePosition, 0, oldestCount, imageHeight);
+
+    if (historyWritePosition > 0)
+        g.drawImage (historyImage, splitX, plot.getY(), plot.getRight() - splitX, plot.getHeight(),
+                     0, 0, historyWritePosition, imageHeight);
+}
+
+//==============================================================================
+// --- Capas cacheadas ---
+
+// Fondo, título y marcos del medidor y del historial: solo cambian con el tamaño
+void SilentRoomAudioProcessorEditor::renderBackground()
+{
+    backgroundImage = juce::Image (juce::Image::RGB,
+                                   juce::jmax (1, juce::roundToInt ((float) getWidth() * imageScale)),
+                                   juce::jmax (1, juce::roundToInt ((float) getHeight() * imageScale)),
+                                   false);
+
+    juce::Graphics g (backgroundImage);
+    g.addTransform (juce::AffineTransform::scale (imageScale));
+
+    // --- Fondo oscuro ---
+    g.fillAll (juce::Colour (0xff1a1a2e));
+
+    // --- Título ---
+    g.setColour (juce::Colour (0xffe0e0ff));
+    g.setFont (juce::FontOptions (20.0f));
+    g.drawText ("SilentRoom – Noise Gate", getLocalBounds().removeFromTop (30),
+                juce::Justification::centred, true);
+
+    // --- Medidor de Gain Reduction: fondo y borde ---
+    g.setColour (juce::Colour (0xff0d0d1a));
+    g.fillRoundedRectangle (meterBounds.toFloat(), 4.0f);
+
+    g.setColour (juce::Colour (0xff3a3a5c));
+    g.drawRoundedRectangle (meterBounds.toFloat(), 4.0f, 1.0f);
+
+    // --- Fondo del historial ---
+    g.setColour (juce::Colour (0xff0d0d1a));
+    g.fillRoundedRectangle (historyBounds.toFloat(), 4.0f);
+}
+
+// Una columna de píxeles por entrada del historial, a la altura física del área
+void SilentRoomAudioProcessorEditor::renderHistory()
+{
+    historyImage = juce::Image (juce::Image::RGB, historyLength,
+                                juce::jmax (8, juce::roundToInt ((float) historyBounds.reduced (2).getHeight() * imageScale)),
+                                true);
+
+    for (int i = 0; i < historyLength; ++i)
+        renderHistoryColumn (i);
+}
+
+// Picos de entrada y salida desde abajo, GR desde arriba (banda mín./máx.)
+// y el estado de la puerta en una línea inferior
+void SilentRoomAudioProcessorEditor::renderHistoryColumn (int index)
+{
+    const auto& column = history[(size_t) index];
+
+    juce::Graphics g (historyImage);
+
+    const float x = (float) index;
+    const float stripHeight = 3.0f * imageScale;
+    const float plotHeight  = (float) historyImage.getHeight() - stripHeight;
+
+    auto levelToHeight = [&] (float db) { return plotHeight * juce::jlimit (0.0f, 1.0f, 1.0f + db / historyRangeDb); };
+    auto grToHeight    = [&] (float db) { return plotHeight * juce::jlimit (0.0f, 1.0f, -db / historyRangeDb); };
+
+    g.setColour (juce::Colour (0xff0d0d1a));
+    g.fillRect (x, 0.0f, 1.0f, plotHeight);
 
-    juce::String grText = "GR: " + juce::String (currentGR, 1) + " dB";
-    g.drawText (grText, meterArea, juce::Justification::centred, true);
+    // Niveles: entrada (tenue) y salida (sobre ella)
+    const float inputHeight  = levelToHeight (column.inputPeakDb);
+    const float outputHeight = levelToHeight (column.outputPeakDb);
+
+    g.setColour (juce::Colour (0xff2e2e4f));
+    g.fillRect (x, plotHeight - inputHeight, 1.0f, inputHeight);
+    g.setColour (juce::Colour (0xff5a6a9a));
+    g.fillRect (x, plotHeight - outputHeight, 1.0f, outputHeight);
+
+    // GR: banda entre la menos y la más profunda del intervalo
+    const float shallow = grToHeight (column.maxGainReductionDb);
+    const float deep    = grToHeight (column.minGainReductionDb);
+
+    g.setColour (juce::Colour (0xffd04060).withAlpha (0.5f));
+    g.fillRect (x, 0.0f, 1.0f, shallow);
+    g.setColour (juce::Colour (0xffd04060));
+    g.fillRect (x, shallow, 1.0f, deep - shallow);
+
+    // Estado: verde abierta, ámbar en movimiento, gris cerrada
+    g.setColour (column.state == GateState::open   ? juce::Colour (0xff40c070)
+               : column.state == GateState::moving ? juce::Colour (0xffe0a030)
+                                                   : juce::Colour (0xff505060));
+    g.fillRect (x, plotHeight, 1.0f, stripHeight);
 }
 
 //==============================================================================
@@ -137,20 +548,93 @@ void SilentRoomAudioProcessorEditor::resized()
 {
     auto bounds = getLocalBounds();
 
-    // Reservar espacio para el título
-    bounds.removeFromTop (40);
+    // --- Zonas dinámicas: medidor de GR (abajo), línea de coste de DSP e historial ---
+    const int meterHeight = 30;
+    const int meterMargin = 20;
+    meterBounds = getLocalBounds().removeFromBottom (meterHeight + meterMargin)
+                      .reduced (meterMargin, 0)
+                      .removeFromTop (meterHeight);
+    dspTextBounds = meterBounds.translated (0, -meterHeight + 8).withHeight (16);
+    historyBounds = getLocalBounds().removeFromBottom (160).removeFromTop (80).reduced (20, 6);
+
+    // Las capas cacheadas dependen del tamaño: se regeneran en el próximo paint
+    backgroundImage = {};
+
+    // Reservar espacio para el título (el selector de enlace va a su derecha)
+    auto titleArea = bounds.removeFromTop (40);
+    linkBox.setBounds (titleArea.removeFromRight (110).reduced (6, 8));
+
+    // Fila de detección: key externa, tipo de filtro y frecuencia
+    auto keyArea = bounds.removeFromTop (30).reduced (10, 3);
+    sidechainButton.setBounds (keyArea.removeFromLeft (90));
+    keyFilterBox.setBounds (keyArea.removeFromLeft (110));
+    keyArea.removeFromLeft (8);
+    keyFreqSlider.setBounds (keyArea);
+
+    // Fila del detector: modo y ventana RMS
+    auto detectorArea = bounds.removeFromTop (30).reduced (10, 3);
+    detectorArea.removeFromLeft (90);
+    detectorBox.setBounds (detectorArea.removeFromLeft (110));
+    detectorArea.removeFromLeft (8);
+    rmsWindowSlider.setBounds (detectorArea);
+
+    // Fila de hold e histéresis: mitad y mitad
+    auto holdArea = bounds.removeFromTop (30).reduced (10, 3);
+    holdSlider.setBounds (holdArea.removeFromLeft (holdArea.getWidth() / 2).reduced (2, 0));
+    hysteresisSlider.setBounds (holdArea.reduced (2, 0));
+
+    // Fila de la curva: rodilla y atenuación máxima
+    auto curveArea = bounds.removeFromTop (30).reduced (10, 3);
+    kneeSlider.setBounds (curveArea.removeFromLeft (curveArea.getWidth() / 2).reduced (2, 0));
+    rangeSlider.setBounds (curveArea.reduced (2, 0));
+
+    // Fila multibanda: número de bandas y los tres cortes
+    auto bandsArea = bounds.removeFromTop (30).reduced (10, 3);
+    bandsBox.setBounds (bandsArea.removeFromLeft (110));
+    bandsArea.removeFromLeft (8);
+
+    const int crossoverWidth = bandsArea.getWidth() / (maxBands - 1);
+
+    for (auto& slider : crossoverSliders)
+        slider.setBounds (bandsArea.removeFromLeft (crossoverWidth).reduced (2, 0));
+
+    // Fila por banda: umbral y ratio de cada una, de grave a agudo
+    auto bandParamsArea = bounds.removeFromTop (30).reduced (10, 3);
+    const int bandWidth = bandParamsArea.getWidth() / maxBands;
+
+    for (int b = 0; b < maxBands; ++b)
+    {
+        auto column = bandParamsArea.removeFromLeft (bandWidth).reduced (2, 0);
+        bandThresholdSliders[b].setBounds (column.removeFromLeft (column.getWidth() * 3 / 5));
+        bandRatioSliders[b].setBounds (column);
+    }
+
+    // Fila del modo espectral: modo, aprendizaje y offset sobre el perfil
+    auto spectralArea = bounds.removeFromTop (30).reduced (10, 3);
+    modeBox.setBounds (spectralArea.removeFromLeft (110));
+    spectralArea.removeFromLeft (8);
+    learnButton.setBounds (spectralArea.removeFromLeft (70));
+    spectralOffsetSlider.setBounds (spectralArea);
+
+    // Fila del umbral automático: activación, margen y estimación
+    auto autoArea = bounds.removeFromTop (30).reduced (10, 3);
+    autoThresholdButton.setBounds (autoArea.removeFromLeft (90));
+    autoMarginSlider.setBounds (autoArea.removeFromLeft (150));
+    autoArea.removeFromLeft (8);
+    noiseFloorLabel.setBounds (autoArea);
 
-    // Reservar espacio para el medidor de GR
-    bounds.removeFromBottom (60);
+    // Reservar espacio para el historial, la línea de coste de DSP y el medidor de GR
+    bounds.removeFromBottom (160);
 
-    // Área central para los sliders (4 en fila)
+    // Área central para los sliders (5 en fila)
     // Dejar margen para los labels (que están encima de los sliders)
     bounds.removeFromTop (20); // espacio para labels
 
-    const int sliderWidth = bounds.getWidth() / 4;
+    const int sliderWidth = bounds.getWidth() / 5;
 
     thresholdSlider.setBounds (bounds.removeFromLeft (sliderWidth));
     ratioSlider.setBounds     (bounds.removeFromLeft (sliderWidth));
     attackSlider.setBounds    (bounds.removeFromLeft (sliderWidth));
-    releaseSlider.setBounds   (bounds);
+    releaseSlider.setBounds   (bounds.removeFromLeft (sliderWidth));
+    lookaheadSlider.setBounds (bounds);
 }
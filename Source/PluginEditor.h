@@ -34,21 +34,131 @@ private:
     juce::Slider ratioSlider;
     juce::Slider attackSlider;
     juce::Slider releaseSlider;
+    juce::Slider lookaheadSlider;
 
     // --- Labels ---
     juce::Label thresholdLabel;
     juce::Label ratioLabel;
     juce::Label attackLabel;
     juce::Label releaseLabel;
+    juce::Label lookaheadLabel;
+
+    // --- Enlace de canales (Linked / Unlinked / Grouped) ---
+    juce::ComboBox linkBox;
+
+    // --- Detección: key externa y filtro de key ---
+    juce::ToggleButton sidechainButton { "Ext. key" };
+    juce::ComboBox keyFilterBox;
+    juce::Slider keyFreqSlider;
+    juce::ComboBox detectorBox;
+    juce::Slider rmsWindowSlider;
+
+    // --- Multibanda: número de bandas, cortes y umbral/ratio por banda ---
+    static constexpr int maxBands = MultibandGateEngine<float>::maxBands;
+
+    juce::ComboBox bandsBox;
+    juce::Slider crossoverSliders[maxBands - 1];
+    juce::Slider bandThresholdSliders[maxBands];
+    juce::Slider bandRatioSliders[maxBands];
+
+    // --- Modo espectral: selector, aprendizaje del ruido y offset ---
+    juce::ComboBox modeBox;
+    juce::ToggleButton learnButton { "Learn" };
+    juce::Slider spectralOffsetSlider;
+
+    // --- Umbral automático: activación, margen y estimación del suelo de ruido ---
+    juce::ToggleButton autoThresholdButton { "Auto thr." };
+    juce::Slider autoMarginSlider;
+    juce::Label noiseFloorLabel;
+
+    // --- Hold e histéresis ---
+    juce::Slider holdSlider;
+    juce::Slider hysteresisSlider;
+
+    // --- Curva: rodilla y atenuación máxima ---
+    juce::Slider kneeSlider;
+    juce::Slider rangeSlider;
 
     // --- Attachments (APVTS -> Sliders) ---
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> thresholdAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> ratioAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attackAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lookaheadAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> linkAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> sidechainAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> keyFilterAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> keyFreqAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> detectorAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> rmsWindowAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> bandsAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverAttachments[maxBands - 1];
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bandThresholdAttachments[maxBands];
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bandRatioAttachments[maxBands];
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> modeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> learnAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> spectralOffsetAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> autoThresholdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> autoMarginAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> holdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> hysteresisAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> kneeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> rangeAttachment;
 
     // --- Gain Reduction Meter ---
     float currentGR = 0.0f;
+    float targetGR  = 0.0f;
+
+    // --- Telemetría: vaciado por lotes e historial desplazable ---
+    // Cada tick del timer resume los bloques recibidos en una columna.
+    struct HistoryColumn
+    {
+        float minGainReductionDb = 0.0f;
+        float maxGainReductionDb = 0.0f;
+        float inputPeakDb  = -100.0f;
+        float outputPeakDb = -100.0f;
+        GateState state = GateState::open;
+    };
+
+    static constexpr int historyLength = 240;   // 4 s a 60 Hz
+    static constexpr float historyRangeDb = 60.0f;
+
+    std::array<GateTelemetryRecord, 256> telemetryBatch {};
+    std::array<HistoryColumn, (size_t) historyLength> history {};
+    int historyWritePosition = 0;   // columna más antigua
+
+    // --- Refresco: 60 Hz con audio, 10 Hz en reposo ---
+    static constexpr int activeRefreshHz = 60;
+    static constexpr int idleRefreshHz   = 10;
+    static constexpr int idleAfterTicks  = 30;        // 0.5 s sin bloques
+    static constexpr int dspTextRefreshTicks = 15;    // coste de DSP a 4 Hz
+
+    int idleTicks = 0;
+    int dspTextTicks = 0;
+
+    // --- Capas cacheadas y repintado por regiones ---
+    juce::Image backgroundImage;   // fondo, título y marcos (se invalida en resized)
+    juce::Image historyImage;      // un píxel de ancho por columna, buffer circular
+    float imageScale = 1.0f;       // escala física con la que se generaron
+
+    juce::Rectangle<int> meterBounds, dspTextBounds, historyBounds;
+
+    // Lo último pintado en cada zona dinámica
+    int meterBarWidth = 0;
+    juce::String meterText { "GR: 0.0 dB" };
+    juce::String dspText;
+
+    bool drainTelemetry (HistoryColumn& column);
+    void pushHistoryColumn (const HistoryColumn& column);
+    void updateMeter();
+    void updateDspText();
+    void updateNoiseFloorText();
+
+    void renderBackground();
+    void renderHistory();
+    void renderHistoryColumn (int index);
+    void paintMeter (juce::Graphics& g) const;
+    void paintHistory (juce::Graphics& g) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SilentRoomAudioProcessorEditor)
 };
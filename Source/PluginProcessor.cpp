@@ -14,8 +14,9 @@ SilentRoomAudioProcessor::SilentRoomAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
      : AudioProcessor (BusesProperties()
                      #if ! JucePlugin_IsMidiEffect
-                      .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                      .withInput  ("Input",     juce::AudioChannelSet::stereo(), true)
+                      .withOutput ("Output",    juce::AudioChannelSet::stereo(), true)
+                      .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                      #endif
                        ),
        apvts(*this, nullptr, "Parameters", createParameterLayout())
@@ -29,16 +30,82 @@ SilentRoomAudioProcessor::SilentRoomAudioProcessor()
     ratioParam     = apvts.getRawParameterValue("RATIO");
     attackParam    = apvts.getRawParameterValue("ATTACK");
     releaseParam   = apvts.getRawParameterValue("RELEASE");
+    lookaheadParam = apvts.getRawParameterValue("LOOKAHEAD");
+    linkParam      = apvts.getRawParameterValue("LINK");
+    sidechainParam = apvts.getRawParameterValue("SIDECHAIN");
+    keyFilterParam = apvts.getRawParameterValue("KEY_FILTER");
+    keyFreqParam   = apvts.getRawParameterValue("KEY_FREQ");
+    detectorParam  = apvts.getRawParameterValue("DETECTOR");
+    rmsWindowParam = apvts.getRawParameterValue("RMS_WINDOW");
+    bandsParam     = apvts.getRawParameterValue("BANDS");
+
+    for (int k = 0; k < MultibandGateEngine<float>::maxBands - 1; ++k)
+        crossoverParams[k] = apvts.getRawParameterValue("XOVER_" + juce::String (k + 1));
+
+    for (int b = 0; b < MultibandGateEngine<float>::maxBands; ++b)
+    {
+        bandThresholdParams[b] = apvts.getRawParameterValue("THRESHOLD_B" + juce::String (b + 1));
+        bandRatioParams[b]     = apvts.getRawParameterValue("RATIO_B" + juce::String (b + 1));
+    }
+
+    modeParam           = apvts.getRawParameterValue("MODE");
+    learnParam          = apvts.getRawParameterValue("LEARN");
+    spectralOffsetParam = apvts.getRawParameterValue("SPECTRAL_OFFSET");
+    autoThresholdParam  = apvts.getRawParameterValue("AUTO_THRESHOLD");
+    autoMarginParam     = apvts.getRawParameterValue("AUTO_MARGIN");
+    holdParam           = apvts.getRawParameterValue("HOLD");
+    hysteresisParam     = apvts.getRawParameterValue("HYSTERESIS");
+    kneeParam           = apvts.getRawParameterValue("KNEE");
+    rangeParam          = apvts.getRawParameterValue("RANGE");
 
     // SAFETY CHECK:
     jassert(thresholdParam != nullptr);
     jassert(ratioParam != nullptr);
     jassert(attackParam != nullptr);
     jassert(releaseParam != nullptr);
+    jassert(lookaheadParam != nullptr);
+    jassert(linkParam != nullptr);
+    jassert(sidechainParam != nullptr);
+    jassert(keyFilterParam != nullptr);
+    jassert(keyFreqParam != nullptr);
+    jassert(detectorParam != nullptr);
+    jassert(rmsWindowParam != nullptr);
+    jassert(bandsParam != nullptr);
+
+    for (auto* param : crossoverParams)
+        jassert(param != nullptr);
+
+    for (int b = 0; b < MultibandGateEngine<float>::maxBands; ++b)
+        jassert(bandThresholdParams[b] != nullptr && bandRatioParams[b] != nullptr);
+
+    jassert(modeParam != nullptr);
+    jassert(learnParam != nullptr);
+    jassert(spectralOffsetParam != nullptr);
+    jassert(autoThresholdParam != nullptr);
+    jassert(autoMarginParam != nullptr);
+    jassert(holdParam != nullptr);
+    jassert(hysteresisParam != nullptr);
+    jassert(kneeParam != nullptr);
+    jassert(rangeParam != nullptr);
+
+    // Umbral automático: la estimación sigue a la sala con ~30 s de memoria
+    noiseFloor.setMemorySeconds (30.0);
+
+    // Notificación de cambios de latencia al host (message thread)
+    startTimerHz (20);
 }
 
 SilentRoomAudioProcessor::~SilentRoomAudioProcessor()
 {
+    stopTimer();
+}
+
+void SilentRoomAudioProcessor::timerCallback()
+{
+    const auto latency = engineLatency.load (std::memory_order_relaxed);
+
+    if (latency != getLatencySamples())
+        setLatencySamples (latency);
 }
 
 //==============================================================================
@@ -81,34 +148,114 @@ double SilentRoomAudioProcessor::getTailLengthSeconds() const
 
 int SilentRoomAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return (int) FactoryPresets::getPrograms().size();
 }
 
 int SilentRoomAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
+// Carga un programa de fábrica: los parámetros que no lista vuelven a su
+// valor por defecto. Todo el conjunto se escribe dentro de un
+// ScopedParameterSetWrite, así que el audio thread nunca procesa un bloque
+// con medio programa.
 void SilentRoomAudioProcessor::setCurrentProgram (int index)
 {
+    const auto& programs = FactoryPresets::getPrograms();
+
+    if (! juce::isPositiveAndBelow (index, (int) programs.size()))
+        return;
+
+    const auto& program = programs[(size_t) index];
+
+    {
+        const ScopedParameterSetWrite write (parameterWriteSequence);
+
+        for (auto* parameter : getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter);
+
+            if (ranged == nullptr)
+                continue;
+
+            float normalised = ranged->getDefaultValue();
+
+            for (const auto& value : program.values)
+                if (ranged->getParameterID() == value.parameterID)
+                    normalised = ranged->convertTo0to1 (value.value);
+
+            ranged->setValueNotifyingHost (normalised);
+        }
+    }
+
+    currentProgram = index;
 }
 
 const juce::String SilentRoomAudioProcessor::getProgramName (int index)
 {
-    return {};
+    const auto& programs = FactoryPresets::getPrograms();
+
+    if (! juce::isPositiveAndBelow (index, (int) programs.size()))
+        return {};
+
+    return programs[(size_t) index].name;
 }
 
 void SilentRoomAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    // Programas de fábrica: los nombres no se pueden cambiar
+    juce::ignoreUnused (index, newName);
 }
 
 //==============================================================================
 void SilentRoomAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Reiniciar estado del seguidor de envolvente al preparar la reproducción
-    envelope = 0.0f;
-    gainReduction.store (0.0f, std::memory_order_relaxed);
+    // Reservar buffers y reiniciar el seguidor de envolvente (nunca en processBlock)
+    auto layout = getChannelLayoutOfBus (true, 0);
+
+    if (layout.isDisabled())
+        layout = juce::AudioChannelSet::canonicalChannelSet (juce::jmax (1, getTotalNumInputChannels()));
+
+    // Solo los motores de la precisión en uso (cada conjunto incluye las
+    // bandas del multibanda y los buffers de la STFT)
+    int spectralLatency = 0;
+
+    if (isUsingDoublePrecision())
+    {
+        floatEngines.reset();
+
+        if (doubleEngines == nullptr)
+            doubleEngines = std::make_unique<GateEngines<double>>();
+
+        doubleEngines->prepare (sampleRate, samplesPerBlock, layout);
+        spectralLatency = doubleEngines->spectral.getLatencySamples();
+    }
+    else
+    {
+        doubleEngines.reset();
+
+        if (floatEngines == nullptr)
+            floatEngines = std::make_unique<GateEngines<float>>();
+
+        floatEngines->prepare (sampleRate, samplesPerBlock, layout);
+        spectralLatency = floatEngines->spectral.getLatencySamples();
+    }
+
+    noiseFloor.prepare (sampleRate);
+    noiseFloorEstimateDb.store (noNoiseFloorEstimate);
+
+    // Punto de partida del primer bloque (aquí no hay cambios de programa a medias)
+    readParameters (blockParameters);
+
+    // Informar al host de la latencia (lookahead o trama de la STFT) antes de
+    // empezar a reproducir
+    const int latency = modeParam->load() >= 0.5f
+                          ? spectralLatency
+                          : GateEngine<float, 1>::lookaheadMsToSamples (lookaheadParam->load(), sampleRate);
+
+    engineLatency.store (latency, std::memory_order_relaxed);
+    setLatencySamples (latency);
 }
 
 void SilentRoomAudioProcessor::releaseResources()
@@ -124,12 +271,11 @@ bool SilentRoomAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Cualquier disposición de 1 a maxChannels canales: mono, estéreo,
+    // 5.1, 7.1.4, ambisónico, canales discretos...
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+
+    if (mainOutput.isDisabled() || mainOutput.size() > MultichannelGateEngine<float>::maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -138,6 +284,17 @@ bool SilentRoomAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
         return false;
    #endif
 
+    // Sidechain: desactivado, mono (alimenta a todos los canales) o con los
+    // mismos canales que el bus principal (canal a canal)
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechain = layouts.getChannelSet (true, 1);
+
+        if (! sidechain.isDisabled() && sidechain.size() != 1
+            && sidechain.size() != layouts.getMainInputChannelSet().size())
+            return false;
+    }
+
     return true;
   #endif
 }
@@ -192,90 +349,620 @@ juce::AudioProcessorValueTreeState::ParameterLayout SilentRoomAudioProcessor::cr
         100.0f // Default 100ms
     ));
 
+    // --- 5. LOOKAHEAD (Anticipación) ---
+    // Rango: 0ms (desactivado) a 10ms. Retrasa el audio para que el ataque
+    // empiece antes del transitorio; añade latencia (se informa al host).
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "LOOKAHEAD",
+        "Lookahead",
+        juce::NormalisableRange<float>(0.0f, GateEngine<float, 1>::maxLookaheadMs, 0.1f),
+        0.0f // Default: sin lookahead
+    ));
+
+    // --- 6. LINK (Enlace de canales) ---
+    // Linked: un detector para todo el bus. Unlinked: uno por canal.
+    // Grouped: uno por función (frontales, LFE, surround, alturas).
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "LINK",
+        "Link",
+        juce::StringArray { "Linked", "Unlinked", "Grouped" },
+        0 // Default: enlazado (como las versiones anteriores)
+    ));
+
+    // --- 7. SIDECHAIN (Key externa) ---
+    // Detectar sobre el bus de sidechain en lugar de la entrada principal.
+    // Sin bus conectado/activado no tiene efecto.
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "SIDECHAIN",
+        "External Key",
+        false
+    ));
+
+    // --- 8. KEY_FILTER (Filtro de detección) ---
+    // Paso alto / bajo / banda delante del detector; el audio no se filtra.
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "KEY_FILTER",
+        "Key Filter",
+        juce::StringArray { "Off", "High-pass", "Low-pass", "Band-pass" },
+        0 // Default: sin filtro (coste cero en el detector)
+    ));
+
+    // --- 9. KEY_FREQ (Frecuencia del filtro de detección) ---
+    // Rango: 20Hz a 20kHz, con 1kHz en el centro del slider.
+    auto keyFreqRange = juce::NormalisableRange<float>(KeyFilter<float>::minFrequencyHz,
+                                                       KeyFilter<float>::maxFrequencyHz, 1.0f);
+    keyFreqRange.setSkewForCentre(1000.0f);
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "KEY_FREQ",
+        "Key Frequency",
+        keyFreqRange,
+        1000.0f
+    ));
+
+    // --- 10. DETECTOR (Modo del detector de nivel) ---
+    // Peak: |x| (el más barato). RMS: media cuadrática deslizante, no
+    // tiembla con material ruidoso. True Peak: pico entre muestras x4.
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "DETECTOR",
+        "Detector",
+        juce::StringArray { "Peak", "RMS", "True Peak" },
+        0 // Default: peak (como las versiones anteriores)
+    ));
+
+    // --- 11. RMS_WINDOW (Ventana del detector RMS) ---
+    // Rango: 1ms a 300ms, con 30ms en el centro del slider.
+    auto rmsWindowRange = juce::NormalisableRange<float>(RunningRms<float>::minWindowMs,
+                                                         RunningRms<float>::maxWindowMs, 0.1f);
+    rmsWindowRange.setSkewForCentre(30.0f);
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "RMS_WINDOW",
+        "RMS Window",
+        rmsWindowRange,
+        10.0f // Default 10ms
+    ));
+
+    // --- 12. BANDS (Modo multibanda) ---
+    // 1 = banda ancha (como las versiones anteriores); 2 a 4 bandas
+    // Linkwitz-Riley, cada una con su propio umbral, ratio y envolvente.
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "BANDS",
+        "Bands",
+        juce::StringArray { "1 (Broadband)", "2", "3", "4" },
+        0
+    ));
+
+    // --- 13. XOVER_1..3 (Frecuencias de cruce) ---
+    // Se ordenan en el motor; solo se usan las numBands - 1 primeras.
+    const float defaultCrossovers[] = { 150.0f, 1000.0f, 5000.0f };
+
+    for (int k = 0; k < MultibandGateEngine<float>::maxBands - 1; ++k)
+    {
+        auto crossoverRange = juce::NormalisableRange<float>(LinkwitzRileySplitter<float>::minFrequencyHz,
+                                                             LinkwitzRileySplitter<float>::maxFrequencyHz, 1.0f);
+        crossoverRange.setSkewForCentre(1000.0f);
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            "XOVER_" + juce::String (k + 1),
+            "Crossover " + juce::String (k + 1),
+            crossoverRange,
+            defaultCrossovers[k]
+        ));
+    }
+
+    // --- 14. THRESHOLD_B1..4 / RATIO_B1..4 (Umbral y ratio por banda) ---
+    // Mismos rangos y valores por defecto que THRESHOLD y RATIO.
+    for (int b = 0; b < MultibandGateEngine<float>::maxBands; ++b)
+    {
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            "THRESHOLD_B" + juce::String (b + 1),
+            "Band " + juce::String (b + 1) + " Threshold",
+            juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f),
+            -60.0f
+        ));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            "RATIO_B" + juce::String (b + 1),
+            "Band " + juce::String (b + 1) + " Ratio",
+            juce::NormalisableRange<float>(1.0f, 50.0f, 0.1f),
+            1.0f
+        ));
+    }
+
+    // --- 15. MODE (Puerta de dominio temporal o espectral) ---
+    // Spectral: puerta por bin de FFT contra el perfil de ruido aprendido.
+    // Añade una latencia de una trama (1024 o 2048 muestras).
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "MODE",
+        "Mode",
+        juce::StringArray { "Gate", "Spectral" },
+        0 // Default: puerta de dominio temporal
+    ));
+
+    // --- 16. LEARN (Aprender el perfil de ruido) ---
+    // Mientras está activo se mide el ruido y la salida pasa sin puerta.
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "LEARN",
+        "Learn Noise",
+        false
+    ));
+
+    // --- 17. SPECTRAL_OFFSET (Umbral por bin sobre el perfil) ---
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "SPECTRAL_OFFSET",
+        "Spectral Offset",
+        juce::NormalisableRange<float>(0.0f, 30.0f, 0.1f),
+        12.0f // Default 12dB por encima del ruido
+    ));
+
+    // --- 18. AUTO_THRESHOLD (Umbral automático) ---
+    // El umbral de banda ancha sigue al suelo de ruido estimado de la señal
+    // de detección (más AUTO_MARGIN). Los umbrales por banda y el modo
+    // espectral no cambian. Apagado, la estimación solo se muestra.
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "AUTO_THRESHOLD",
+        "Auto Threshold",
+        false
+    ));
+
+    // --- 19. AUTO_MARGIN (Margen sobre el suelo de ruido) ---
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "AUTO_MARGIN",
+        "Auto Margin",
+        juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f),
+        6.0f // Default 6dB por encima del ruido
+    ));
+
+    // --- 20. HOLD (Mantener abierta) ---
+    // Rango: 0ms (desactivado) a 500ms, con 50ms en el centro del slider.
+    // Tras caer por debajo del umbral de cierre, la puerta sigue abierta
+    // este tiempo antes de empezar el release: sin cortes en pausas cortas.
+    auto holdRange = juce::NormalisableRange<float>(0.0f, 500.0f, 0.1f);
+    holdRange.setSkewForCentre(50.0f);
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "HOLD",
+        "Hold",
+        holdRange,
+        0.0f // Default: sin hold (como las versiones anteriores)
+    ));
+
+    // --- 21. HYSTERESIS (Histéresis) ---
+    // Abre al superar THRESHOLD y solo cierra por debajo de THRESHOLD -
+    // HYSTERESIS: el ruido que ronda el umbral ya no hace vibrar la puerta.
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "HYSTERESIS",
+        "Hysteresis",
+        juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f),
+        0.0f // Default: un solo umbral (como las versiones anteriores)
+    ));
+
+    // --- 22. KNEE (Rodilla) ---
+    // Ancho en dB de la transición suave centrada en THRESHOLD: la GR
+    // empieza a crecer KNEE/2 por encima del umbral en lugar de saltar en él.
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "KNEE",
+        "Knee",
+        juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f),
+        0.0f // Default: rodilla dura (como las versiones anteriores)
+    ));
+
+    // --- 23. RANGE (Atenuación máxima) ---
+    // La puerta cerrada atenúa como mucho RANGE dB en lugar de silenciar:
+    // deja algo de ambiente y la envolvente se asienta antes (ruta rápida).
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "RANGE",
+        "Range",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
+        100.0f // Default: hasta el suelo de -100 dB (como las versiones anteriores)
+    ));
+
     return layout;
 }
 
+//==============================================================================
+// Llama a fn con el motor indicado (mono, estéreo, multicanal, multibanda o espectral).
+template <typename Engines, typename Function>
+static void withEngine (Engines& engines, typename Engines::Active which, Function&& fn)
+{
+    switch (which)
+    {
+        case Engines::monoEngine:          fn (engines.mono);         break;
+        case Engines::stereoEngine:        fn (engines.stereo);       break;
+        case Engines::multichannelEngine:  fn (engines.multichannel); break;
+        case Engines::multibandEngine:     fn (engines.multiband);    break;
+        case Engines::spectralEngine:      fn (engines.spectral);     break;
+        default:                           break;
+    }
+}
+
+// Llama a fn con el motor activo
+template <typename Engines, typename Function>
+static void withActiveEngine (Engines& engines, Function&& fn)
+{
+    withEngine (engines, engines.active, std::forward<Function> (fn));
+}
+
+// Pico lineal de los primeros numChannels canales del buffer
+template <typename SampleType>
+static float getPeak (const juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    SampleType peak = SampleType (0);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        peak = juce::jmax (peak, buffer.getMagnitude (ch, 0, buffer.getNumSamples()));
+
+    return static_cast<float> (peak);
+}
+
+// Lee todos los parámetros de los atómicos del APVTS (unidades reales)
+void SilentRoomAudioProcessor::readParameters (BlockParameters& dest) const noexcept
+{
+    auto& params = dest.gate;
+    params.thresholdDb = thresholdParam->load (std::memory_order_relaxed);  // dB
+    params.ratio       = ratioParam->load     (std::memory_order_relaxed);  // N:1
+    params.attackMs    = attackParam->load     (std::memory_order_relaxed);  // ms
+    params.releaseMs   = releaseParam->load    (std::memory_order_relaxed);  // ms
+    params.lookaheadMs = lookaheadParam->load  (std::memory_order_relaxed);  // ms
+    params.keyFilter   = static_cast<KeyFilterMode> (juce::roundToInt (keyFilterParam->load (std::memory_order_relaxed)));
+    params.keyFrequencyHz = keyFreqParam->load (std::memory_order_relaxed);  // Hz
+    params.detector    = static_cast<DetectorMode> (juce::roundToInt (detectorParam->load (std::memory_order_relaxed)));
+    params.rmsWindowMs = rmsWindowParam->load (std::memory_order_relaxed);  // ms
+    params.holdMs       = holdParam->load (std::memory_order_relaxed);        // ms
+    params.hysteresisDb = hysteresisParam->load (std::memory_order_relaxed);  // dB
+    params.kneeDb       = kneeParam->load (std::memory_order_relaxed);        // dB
+    params.rangeDb      = rangeParam->load (std::memory_order_relaxed);       // dB
+
+    dest.linkMode     = static_cast<GateLinkMode> (juce::roundToInt (linkParam->load (std::memory_order_relaxed)));
+    dest.spectralMode = modeParam->load (std::memory_order_relaxed) >= 0.5f;
+    dest.sidechain    = sidechainParam->load (std::memory_order_relaxed) >= 0.5f;
+
+    auto& bands = dest.bands;
+    bands.numBands = juce::roundToInt (bandsParam->load (std::memory_order_relaxed)) + 1;
+
+    for (int k = 0; k < MultibandGateEngine<float>::maxBands - 1; ++k)
+        bands.crossoverHz[k] = crossoverParams[k]->load (std::memory_order_relaxed);
+
+    for (int b = 0; b < MultibandGateEngine<float>::maxBands; ++b)
+    {
+        bands.thresholdDb[b] = bandThresholdParams[b]->load (std::memory_order_relaxed);
+        bands.ratio[b]       = bandRatioParams[b]->load (std::memory_order_relaxed);
+    }
+
+    dest.spectral.profileOffsetDb = spectralOffsetParam->load (std::memory_order_relaxed);
+    dest.spectral.learning        = learnParam->load (std::memory_order_relaxed) >= 0.5f;
+
+    dest.autoThreshold = autoThresholdParam->load (std::memory_order_relaxed) >= 0.5f;
+    dest.autoMarginDb  = autoMarginParam->load (std::memory_order_relaxed);
+}
+
+//==============================================================================
+float SilentRoomAudioProcessor::noiseFloorToThresholdDb (float noiseFloorDb, float marginDb) noexcept
+{
+    return juce::jlimit (-60.0f, 0.0f, noiseFloorDb + marginDb);
+}
+
+bool SilentRoomAudioProcessor::getNoiseFloorEstimate (float& noiseFloorDb, float& suggestedThresholdDb) const noexcept
+{
+    const float estimate = noiseFloorEstimateDb.load (std::memory_order_relaxed);
+
+    if (estimate == noNoiseFloorEstimate)
+        return false;
+
+    noiseFloorDb = estimate;
+    suggestedThresholdDb = noiseFloorToThresholdDb (estimate, autoMarginParam->load (std::memory_order_relaxed));
+    return true;
+}
+
+GateParameters SilentRoomAudioProcessor::getGateParameters() const noexcept
+{
+    BlockParameters current;
+    readParameters (current);
+    return current.gate;
+}
+
+// Lectura del lado del audio thread del seqlock: dest solo se actualiza si el
+// conjunto se leyó entero sin ninguna escritura en curso. Devuelve false si
+// se mantuvo el anterior.
+bool SilentRoomAudioProcessor::readParameterSet (BlockParameters& dest) const noexcept
+{
+    const auto sequence = parameterWriteSequence.load (std::memory_order_acquire);
+
+    if ((sequence & 1u) != 0)
+        return false;
+
+    BlockParameters candidate;
+    readParameters (candidate);
+
+    std::atomic_thread_fence (std::memory_order_acquire);
+
+    if (parameterWriteSequence.load (std::memory_order_relaxed) != sequence)
+        return false;
+
+    dest = candidate;
+    return true;
+}
+
+// Ejecuta un bloque en el motor de la disposición de canales activa.
+template <typename Engine, typename SampleType>
+static float runGateEngine (Engine& engine, const GateParameters& params, bool fastMath,
+                            SampleType* const* channels, int numSamples,
+                            const SampleType* const* keyChannels)
+{
+    engine.setParameters (params);
+    engine.setFastMathEnabled (fastMath);
+
+   #if SILENTROOM_SCALAR_REFERENCE
+    return static_cast<float> (engine.processReference (channels, numSamples, keyChannels));
+   #else
+    return static_cast<float> (engine.process (channels, numSamples, keyChannels));
+   #endif
+}
+
 void SilentRoomAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    // Sin motores float: el host no ha llamado a prepareToPlay en esta precisión
+    if (floatEngines == nullptr)
+    {
+        jassertfalse;
+        return;
+    }
+
+    processGate (buffer, *floatEngines);
+}
+
+void SilentRoomAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    if (doubleEngines == nullptr)
+    {
+        jassertfalse;
+        return;
+    }
+
+    processGate (buffer, *doubleEngines);
+}
+
+bool SilentRoomAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+// Ambas precisiones comparten el mismo código de GateEngine: coeficientes,
+// gain computer y balística se evalúan con las mismas fórmulas y en el mismo
+// orden, así que la envolvente en double sigue a la de float salvo el redondeo
+// propio de cada tipo. FastMath solo existe para float; en double se usan
+// siempre los kernels exactos.
+template <typename SampleType>
+void SilentRoomAudioProcessor::processGate (juce::AudioBuffer<SampleType>& buffer, GateEngines<SampleType>& engines)
 {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // Medir el bloque completo y, en debug, vigilar reservas/locks en este tramo
+    RealtimeGuard::ScopedRealtimeSection realtimeSection;
+    const BlockTimingStats::ScopedBlockTimer blockTimer (timingStats, buffer.getNumSamples(), getSampleRate());
+
+    // Solo el bus principal: los canales de sidechain van detrás en el buffer
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
+    auto totalNumOutputChannels = getMainBusNumOutputChannels();
 
     // Limpiar canales extra (rutina estándar)
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    if (totalNumInputChannels == 0)
+        return;
+
     // --- LECTURA ATÓMICA DE PARÁMETROS (LOCK-FREE) ---
-    const float threshold = thresholdParam->load (std::memory_order_relaxed);  // dB
-    const float ratio     = ratioParam->load     (std::memory_order_relaxed);  // N:1
-    const float attackMs  = attackParam->load     (std::memory_order_relaxed);  // ms
-    const float releaseMs = releaseParam->load    (std::memory_order_relaxed);  // ms
+    // Con un cambio de programa o de estado a medias, el bloque sigue con el
+    // conjunto anterior completo
+    readParameterSet (blockParameters);
 
-    // --- COEFICIENTES DE BALÍSTICA (fuera del bucle de muestras) ---
-    const double sr = getSampleRate();
-    const float alphaAttack  = std::exp (-1.0f / static_cast<float>(attackMs  * 0.001 * sr));
-    const float alphaRelease = std::exp (-1.0f / static_cast<float>(releaseMs * 0.001 * sr));
+    auto params = blockParameters.gate;
+    const bool fastMath = fastMathEnabled.load (std::memory_order_relaxed);
+    const auto linkMode = blockParameters.linkMode;
+    const int numBands  = blockParameters.bands.numBands;
+    const bool spectral = blockParameters.spectralMode;
 
-    const int numSamples = buffer.getNumSamples();
+    // Los motores multicanal, multibanda y espectral se preparan con el bus
+    // principal; si el host cambia la disposición, siempre vuelve a llamar a
+    // prepareToPlay
+    if ((totalNumInputChannels > 2 || numBands > 1 || spectral) && totalNumInputChannels != engines.multiband.getNumChannels())
+    {
+        jassertfalse;
+        return;
+    }
 
-    // --- CACHE DE PUNTEROS DE CANAL (fuera del bucle de muestras) ---
-    auto* leftChannel  = buffer.getWritePointer (0);
-    auto* rightChannel = (totalNumInputChannels > 1) ? buffer.getWritePointer (1) : nullptr;
+    // --- SELECCIÓN DE MOTOR ---
+    // Mono y estéreo con un único grupo de detección: motores especializados
+    // en tiempo de compilación. Resto de buses y modos: motor multicanal.
+    // Con más de una banda, el multibanda con cualquier bus. El modo
+    // espectral tiene prioridad sobre ambos.
+    using Engines = GateEngines<SampleType>;
+    engines.multichannel.setLinkMode (linkMode);
 
-    // Valor máximo de GR en este bloque (para el medidor de la GUI)
-    float maxGR = 0.0f;
+    if (numBands > 1)
+    {
+        engines.multiband.setLinkMode (linkMode);
+        engines.multiband.setMultibandParameters (blockParameters.bands);
+    }
+
+    if (spectral)
+    {
+        engines.spectral.setLinkMode (linkMode);
+        engines.spectral.setSpectralParameters (blockParameters.spectral);
+    }
 
-    // Umbral mínimo de nivel lineal para evitar log10(0)
-    constexpr float kMinLinearLevel = 1.0e-10f;  // ~-200 dB
+    const auto selected = spectral ? Engines::spectralEngine
+                        : numBands > 1 ? Engines::multibandEngine
+                        : totalNumInputChannels == 1 ? Engines::monoEngine
+                        : (totalNumInputChannels == 2 && engines.multichannel.getNumGroups() == 1) ? Engines::stereoEngine
+                        : Engines::multichannelEngine;
 
-    // --- BUCLE DE MUESTRAS ---
-    for (int sample = 0; sample < numSamples; ++sample)
+    if (selected != engines.active)
     {
-        // 1. Detección de nivel: Peak estéreo enlazado (máximo de ambos canales)
-        float peakLevel = std::fabs (leftChannel[sample]);
+        // Relevo (cambio de LINK): el motor nuevo continúa desde la GR del
+        // anterior. Con lookahead activo, la entrada que el anterior aún
+        // retenía pasa por el motor nuevo (salida descartada) para llenar su
+        // retardo y su ventana de detección: sale después, sin hueco.
+        SampleType previousEnvelope = SampleType (0);
+        int numPending = 0;
+
+        withActiveEngine (engines, [&] (auto& engine)
+        {
+            previousEnvelope = engine.getEnvelope();
+            numPending = engine.copyPendingInput (engines.relayBuffer.getArrayOfWritePointers());
+        });
 
-        if (rightChannel != nullptr)
+        // Cambio de BANDS o MODE: el motor saliente se funde con el entrante
+        const auto involvesFade = [] (int e) { return e == Engines::multibandEngine || e == Engines::spectralEngine; };
+
+        if (engines.active != Engines::none && (involvesFade (engines.active) || involvesFade (selected)))
+        {
+            engines.fadingOut   = engines.active;
+            engines.fadePrimed  = numPending;
+            engines.fadeHold    = -1;
+            engines.fadeElapsed = 0;
+        }
+        else
         {
-            const float rightAbs = std::fabs (rightChannel[sample]);
-            if (rightAbs > peakLevel)
-                peakLevel = rightAbs;
+            engines.fadingOut = Engines::none;
         }
 
-        // 2. Protección matemática + conversión a dB
-        peakLevel = std::fmax (peakLevel, kMinLinearLevel);
-        const float levelDb = juce::Decibels::gainToDecibels (peakLevel, -100.0f);
+        engines.active = selected;
+        withActiveEngine (engines, [&] (auto& engine)
+        {
+            engine.reset();
+
+            if (numPending > 0)
+                runGateEngine (engine, params, fastMath, engines.relayBuffer.getArrayOfWritePointers(), numPending, nullptr);
+
+            engine.setEnvelope (previousEnvelope);
+        });
+    }
+
+    // --- KEY EXTERNA ---
+    // Punteros de solo lectura al bus de sidechain dentro del propio buffer
+    // del host (sin copias). Un sidechain mono alimenta a todos los canales.
+    const SampleType* const* keyChannels = nullptr;
+    const int numSidechainChannels = getChannelCountOfBus (true, 1);
 
-        // 3. Gain Computer: reducción de ganancia objetivo (en dB, <= 0)
-        float targetGR = 0.0f;
+    if (numSidechainChannels > 0 && blockParameters.sidechain)
+    {
+        const int firstSidechainChannel = getChannelIndexInProcessBlockBuffer (true, 1, 0);
+
+        for (int ch = 0; ch < totalNumInputChannels; ++ch)
+            engines.keyChannels[(size_t) ch] = buffer.getReadPointer (firstSidechainChannel + ch % numSidechainChannels);
+
+        keyChannels = engines.keyChannels.data();
+    }
 
-        if (levelDb < threshold)
+    // --- UMBRAL AUTOMÁTICO ---
+    // Se analiza la misma señal que ve el detector (key externa o entrada)
+    // antes de la puerta; la estimación se publica al cerrar cada ventana
+    const int numSamples = buffer.getNumSamples();
+    const auto* const* analysedChannels = keyChannels != nullptr ? keyChannels : buffer.getArrayOfReadPointers();
+
+    if (noiseFloor.process (analysedChannels, totalNumInputChannels, numSamples) > 0 && noiseFloor.hasEstimate())
+        noiseFloorEstimateDb.store (noiseFloor.getQuantileDb(), std::memory_order_relaxed);
+
+    if (blockParameters.autoThreshold && noiseFloor.hasEstimate())
+        params.thresholdDb = noiseFloorToThresholdDb (noiseFloorEstimateDb.load (std::memory_order_relaxed),
+                                                      blockParameters.autoMarginDb);
+
+    // --- PROCESADO ---
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    // Fundido en curso: el motor saliente procesa una copia de la entrada
+    const int numFadeSamples = engines.fadingOut != Engines::none
+                                 ? juce::jmin (numSamples, engines.fadeBuffer.getNumSamples()) : 0;
+
+    if (numFadeSamples > 0)
+    {
+        for (int ch = 0; ch < totalNumInputChannels; ++ch)
+            engines.fadeBuffer.copyFrom (ch, 0, buffer, ch, 0, numFadeSamples);
+
+        withEngine (engines, engines.fadingOut, [&] (auto& engine)
         {
-            const float belowThreshold = threshold - levelDb;
-            targetGR = -belowThreshold * (1.0f - (1.0f / ratio));
-        }
+            runGateEngine (engine, params, fastMath, engines.fadeBuffer.getArrayOfWritePointers(), numFadeSamples, keyChannels);
+        });
+    }
+
+    GateTelemetryRecord record;
+    record.numSamples = (juce::uint32) numSamples;
+    record.inputPeak  = getPeak (buffer, totalNumInputChannels);
+
+    float maxGR = 0.0f;
+    float startGR = 0.0f, endGR = 0.0f;
+    int latency = 0;
+    GatePathCounts pathCounts;
+
+    withActiveEngine (engines, [&] (auto& engine)
+    {
+        startGR = static_cast<float> (engine.getEnvelope());
+        maxGR   = runGateEngine (engine, params, fastMath, channels, numSamples, keyChannels);
+        endGR   = static_cast<float> (engine.getEnvelope());
 
-        // 4. Balística Attack/Release con filtro de un polo
-        //    GATE: Attack = puerta se ABRE (envelope sube hacia 0 dB)
-        //           Release = puerta se CIERRA (envelope baja hacia -N dB)
-        const float alpha = (targetGR > envelope) ? alphaAttack : alphaRelease;
-        envelope = targetGR + alpha * (envelope - targetGR);
+        // Cambiar el lookahead cambia la latencia: el motor ya la ha aplicado sin
+        // reservar memoria; aquí solo se publica (el timer avisa al host).
+        latency = engine.getLatencySamples();
 
-        // 5. Convertir GR suavizada de dB a factor lineal
-        const float gainLinear = juce::Decibels::decibelsToGain (envelope, -100.0f);
+        // Tasa de acierto de las rutas rápidas
+        pathCounts = engine.getLastPathCounts();
+    });
 
-        // 6. Aplicar ganancia a todos los canales
-        leftChannel[sample] *= gainLinear;
+    openPathCount.fetch_add   (pathCounts.open,   std::memory_order_relaxed);
+    closedPathCount.fetch_add (pathCounts.closed, std::memory_order_relaxed);
+    fullPathCount.fetch_add   (pathCounts.full,   std::memory_order_relaxed);
 
-        if (rightChannel != nullptr)
-            rightChannel[sample] *= gainLinear;
+    engineLatency.store (latency, std::memory_order_relaxed);
 
-        // 7. Tracking del máximo GR para el medidor GUI
-        if (envelope < maxGR)
-            maxGR = envelope;
+    if (numFadeSamples > 0)
+    {
+        // El entrante da salida válida cuando su retardo se ha llenado (el
+        // relevo ya le dio fadePrimed muestras); hasta entonces, solo el saliente
+        if (engines.fadeHold < 0)
+            engines.fadeHold = juce::jmax (0, latency - engines.fadePrimed);
+
+        const auto* const* outgoing = engines.fadeBuffer.getArrayOfReadPointers();
+        const int fadeStart = engines.fadeHold - engines.fadeElapsed;
+        const auto fadeStep = SampleType (1) / SampleType (engines.fadeLength);
+
+        for (int ch = 0; ch < totalNumInputChannels; ++ch)
+        {
+            for (int i = 0; i < numFadeSamples; ++i)
+            {
+                const auto incoming = juce::jlimit (SampleType (0), SampleType (1), SampleType (i - fadeStart) * fadeStep);
+                channels[ch][i] = outgoing[ch][i] + incoming * (channels[ch][i] - outgoing[ch][i]);
+            }
+        }
+
+        // Fundido completo (o bloque mayor que el preparado): solo el entrante
+        engines.fadeElapsed += numFadeSamples;
+
+        if (engines.fadeElapsed >= engines.fadeHold + engines.fadeLength || numFadeSamples < numSamples)
+            engines.fadingOut = Engines::none;
     }
 
-    // Publicar la reducción de ganancia máxima del bloque (valor negativo en dB)
-    gainReduction.store (maxGR, std::memory_order_relaxed);
+    // --- TELEMETRÍA ---
+    // GR mínima: la que devuelve el motor (exacta). GR máxima: la mayor de la
+    // envolvente al principio y al final del bloque (exacta salvo que la
+    // puerta abra y vuelva a cerrar dentro del mismo bloque).
+    record.minGainReductionDb = maxGR;
+    record.maxGainReductionDb = juce::jmax (maxGR, startGR, endGR);
+    record.outputPeak         = getPeak (buffer, totalNumOutputChannels);
+
+    if (pathCounts.open + pathCounts.closed + pathCounts.full == 0)
+        record.state = maxGR >= (float) GateGainComputer<float>::settledOpenDb ? GateState::open : GateState::moving;
+    else if (pathCounts.closed + pathCounts.full == 0)
+        record.state = GateState::open;
+    else if (pathCounts.open + pathCounts.full == 0)
+        record.state = GateState::closed;
+    else
+        record.state = GateState::moving;
+
+    // Sin editor abierto el FIFO se llena y los registros se descartan
+    telemetry.push (record);
 }
 
 //==============================================================================
@@ -290,17 +977,67 @@ juce::AudioProcessorEditor* SilentRoomAudioProcessor::createEditor()
 }
 
 //==============================================================================
+// --- ESTADO ---
+// Formato binario: "SRst" (uint32 little-endian), versión (int32) y el
+// ValueTree del APVTS con ValueTree::writeToStream (más compacto y rápido
+// de leer que el XML). El programa cargado va como propiedad del árbol.
 void SilentRoomAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    auto state = apvts.copyState();
+    state.setProperty ("program", currentProgram, nullptr);
+
+    juce::MemoryOutputStream output (destData, false);
+    output.writeInt ((int) stateMagic);
+    output.writeInt (stateVersion);
+    state.writeToStream (output);
 }
 
 void SilentRoomAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    const bool restored = restoreState (data, sizeInBytes);
+    jassertquiet (restored);
+}
+
+// Acepta el formato binario (cualquier versión <= stateVersion), el XML
+// envuelto de copyXmlToBinary y XML en texto plano (presets exportados)
+bool SilentRoomAudioProcessor::restoreState (const void* data, int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes <= 0)
+        return false;
+
+    juce::ValueTree state;
+    juce::MemoryInputStream input (data, (size_t) sizeInBytes, false);
+
+    if (sizeInBytes >= 8 && (juce::uint32) input.readInt() == stateMagic)
+    {
+        const int version = input.readInt();
+
+        // Un estado guardado por una versión más nueva no se interpreta a ciegas
+        if (version < 1 || version > stateVersion)
+            return false;
+
+        state = juce::ValueTree::readFromStream (input);
+    }
+    else if (auto xml = getXmlFromBinary (data, sizeInBytes))
+    {
+        state = juce::ValueTree::fromXml (*xml);
+    }
+    else if (auto plainXml = juce::parseXML (juce::String::fromUTF8 (static_cast<const char*> (data), sizeInBytes)))
+    {
+        state = juce::ValueTree::fromXml (*plainXml);
+    }
+
+    if (! state.hasType (apvts.state.getType()))
+        return false;
+
+    {
+        // Todos los parámetros del estado llegan al audio thread a la vez
+        const ScopedParameterSetWrite write (parameterWriteSequence);
+        apvts.replaceState (state);
+    }
+
+    currentProgram = juce::jlimit (0, getNumPrograms() - 1, (int) state.getProperty ("program", 0));
+    return true;
 }
 
 //==============================================================================
@@ -9,11 +9,36 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "GateEngine.h"
+#include "MultichannelGateEngine.h"
+#include "MultibandGateEngine.h"
+#include "SpectralGateEngine.h"
+#include "NoiseFloorAnalyser.h"
+#include "BlockTimingStats.h"
+#include "GateTelemetry.h"
+#include "FactoryPresets.h"
+#include "RealtimeGuard.h"
+
+// Si vale 1, processBlock usa el bucle escalar original muestra a muestra.
+// Se mantiene como referencia para validar la ruta vectorizada por bloques.
+#ifndef SILENTROOM_SCALAR_REFERENCE
+ #define SILENTROOM_SCALAR_REFERENCE 0
+#endif
+
+// Valor inicial del selector de kernels dB <-> lineal de la ruta vectorizada:
+// 1 = aproximaciones rápidas (FastMath.h), 0 = exactas (std::log10/std::pow).
+// Por defecto exactas: float y double dan la misma envolvente. FastMath es
+// opcional (solo aplica a float) y se puede activar en tiempo de ejecución
+// con setFastMathEnabled().
+#ifndef SILENTROOM_FAST_MATH
+ #define SILENTROOM_FAST_MATH 0
+#endif
 
 //==============================================================================
 /**
 */
-class SilentRoomAudioProcessor  : public juce::AudioProcessor
+class SilentRoomAudioProcessor  : public juce::AudioProcessor,
+                                  private juce::Timer
 {
 public:
     //==============================================================================
@@ -29,6 +54,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // Procesado nativo en 64 bits: el host no convierte a float y de vuelta.
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -53,6 +82,14 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    // Restaura un estado binario (getStateInformation) o XML de versiones
+    // anteriores. Devuelve false si los datos no son un estado de SilentRoom.
+    bool restoreState (const void* data, int sizeInBytes);
+
+    // Formato binario del estado: cabecera + ValueTree del APVTS
+    static constexpr juce::uint32 stateMagic   = 0x74735253;   // "SRst"
+    static constexpr int          stateVersion = 1;
+
 private:
     // 1. Declaramos la función que define la estructura de datos
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -63,9 +100,38 @@ private:
 public:
     juce::AudioProcessorValueTreeState apvts;
 
-    // --- Reducción de Ganancia para GUI (Fase 4) ---
-    // Público para que el Editor pueda leerlo para el medidor de GR.
-    std::atomic<float> gainReduction { 0.0f };
+    // --- Telemetría para la GUI (medidor de GR e historial) ---
+    // Un registro por bloque; el audio thread solo escribe, el editor vacía
+    // el FIFO por lotes en su timer.
+    GateTelemetryFifo telemetry;
+
+    // --- Estadísticas de rutas rápidas (sub-bloques de GateEngine por ruta) ---
+    // Acumuladas desde el audio thread; legibles sin bloqueo desde cualquier hilo.
+    std::atomic<juce::uint64> openPathCount   { 0 };  // puerta abierta: sin etapa de ganancia
+    std::atomic<juce::uint64> closedPathCount { 0 };  // puerta cerrada: ganancia constante
+    std::atomic<juce::uint64> fullPathCount   { 0 };  // ruta completa (log/exp por muestra)
+
+    // --- Tiempo de CPU por bloque (histograma, peor caso, fuera de plazo) ---
+    // Escrito solo por el audio thread; getSnapshot() es seguro desde cualquier hilo.
+    BlockTimingStats timingStats;
+
+    // --- Suelo de ruido estimado (umbral automático) ---
+    // Lo publica el audio thread al completar cada ventana de análisis;
+    // legible sin bloqueo desde cualquier hilo. Devuelve false hasta haber
+    // analizado ~1 s de señal (sin contar el silencio digital).
+    bool getNoiseFloorEstimate (float& noiseFloorDb, float& suggestedThresholdDb) const noexcept;
+
+    // Umbral para un suelo de ruido y un margen, dentro del rango de THRESHOLD
+    static float noiseFloorToThresholdDb (float noiseFloorDb, float marginDb) noexcept;
+
+    // Parámetros de la puerta de banda ancha tal como los leería el próximo
+    // bloque (sin el umbral automático). Para renders offline fuera de
+    // processBlock (SilentRoomBatch --index).
+    GateParameters getGateParameters() const noexcept;
+
+    // --- Selector de kernels dB <-> lineal (para medir exactos vs rápidos) ---
+    void setFastMathEnabled (bool shouldUseFastMath) noexcept  { fastMathEnabled.store (shouldUseFastMath, std::memory_order_relaxed); }
+    bool isFastMathEnabled() const noexcept                    { return fastMathEnabled.load (std::memory_order_relaxed); }
 
 private:
     // --- Punteros Atómicos para Acceso Rápido (Cache) ---
@@ -73,9 +139,149 @@ private:
     std::atomic<float>* ratioParam = nullptr;
     std::atomic<float>* attackParam = nullptr;
     std::atomic<float>* releaseParam = nullptr;
+    std::atomic<float>* lookaheadParam = nullptr;
+    std::atomic<float>* linkParam = nullptr;
+    std::atomic<float>* sidechainParam = nullptr;
+    std::atomic<float>* keyFilterParam = nullptr;
+    std::atomic<float>* keyFreqParam = nullptr;
+    std::atomic<float>* detectorParam = nullptr;
+    std::atomic<float>* rmsWindowParam = nullptr;
+    std::atomic<float>* bandsParam = nullptr;
+    std::atomic<float>* crossoverParams[MultibandGateEngine<float>::maxBands - 1] = {};
+    std::atomic<float>* bandThresholdParams[MultibandGateEngine<float>::maxBands] = {};
+    std::atomic<float>* bandRatioParams[MultibandGateEngine<float>::maxBands] = {};
+    std::atomic<float>* modeParam = nullptr;
+    std::atomic<float>* learnParam = nullptr;
+    std::atomic<float>* spectralOffsetParam = nullptr;
+    std::atomic<float>* autoThresholdParam = nullptr;
+    std::atomic<float>* autoMarginParam = nullptr;
+    std::atomic<float>* holdParam = nullptr;
+    std::atomic<float>* hysteresisParam = nullptr;
+    std::atomic<float>* kneeParam = nullptr;
+    std::atomic<float>* rangeParam = nullptr;
+
+    std::atomic<bool> fastMathEnabled { SILENTROOM_FAST_MATH != 0 };
+
+    // --- Latencia del motor activo ---
+    // El audio thread solo publica la latencia del motor (cambia con LOOKAHEAD
+    // o MODE); el timer la notifica al host desde el message thread, igual que
+    // prepareToPlay. setLatencySamples nunca se llama desde processBlock.
+    std::atomic<int> engineLatency { 0 };
+
+    void timerCallback() override;
+
+    // --- Conjunto de parámetros de un bloque ---
+    // processGate lee todos los parámetros a la vez y solo adopta el conjunto
+    // si nadie lo estaba reescribiendo (seqlock sobre parameterWriteSequence).
+    // Un cambio de programa o de estado se ve completo o no se ve: el bloque
+    // sigue con el conjunto anterior. Sin locks ni reservas en el audio thread.
+    struct BlockParameters
+    {
+        GateParameters gate;
+        MultibandParameters bands;
+        SpectralParameters spectral;
+        GateLinkMode linkMode = GateLinkMode::linked;
+        bool spectralMode = false;
+        bool sidechain    = false;
+        bool autoThreshold = false;
+        float autoMarginDb = 6.0f;
+    };
+
+    BlockParameters blockParameters;                          // solo audio thread
+    std::atomic<juce::uint32> parameterWriteSequence { 0 };   // impar mientras se escribe
+
+    void readParameters (BlockParameters& dest) const noexcept;
+    bool readParameterSet (BlockParameters& dest) const noexcept;
+
+    // Escritura de varios parámetros como un conjunto (message thread)
+    struct ScopedParameterSetWrite
+    {
+        explicit ScopedParameterSetWrite (std::atomic<juce::uint32>& s) noexcept : sequence (s)
+        {
+            sequence.fetch_add (1, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_release);
+        }
+
+        ~ScopedParameterSetWrite()  { sequence.fetch_add (1, std::memory_order_release); }
+
+        std::atomic<juce::uint32>& sequence;
+    };
+
+    // --- Umbral automático ---
+    // El analizador solo lo toca el audio thread (float y double nunca a la
+    // vez); la estimación se publica en el atómico para la GUI y el host.
+    static constexpr float noNoiseFloorEstimate = std::numeric_limits<float>::lowest();
+
+    NoiseFloorAnalyser noiseFloor;
+    std::atomic<float> noiseFloorEstimateDb { noNoiseFloorEstimate };
+
+    // Programa cargado (índice en FactoryPresets::getPrograms())
+    int currentProgram = 0;
+
+    // --- Núcleo DSP de la puerta (Noise Gate) ---
+    // Mono y estéreo enlazado usan los motores especializados en tiempo de
+    // compilación; cualquier otro bus o modo de enlace, el multicanal. Con
+    // BANDS > 1, el multibanda (un multicanal por banda). Con MODE = Spectral,
+    // la puerta por bin de FFT.
+    template <typename SampleType>
+    struct GateEngines
+    {
+        enum Active { none = -1, monoEngine, stereoEngine, multichannelEngine, multibandEngine, spectralEngine };
+
+        void prepare (double sampleRate, int samplesPerBlock, const juce::AudioChannelSet& layout)
+        {
+            mono.prepare (sampleRate, samplesPerBlock);
+            stereo.prepare (sampleRate, samplesPerBlock);
+            multichannel.prepare (sampleRate, samplesPerBlock, layout);
+            multiband.prepare (sampleRate, samplesPerBlock, layout);
+            spectral.prepare (sampleRate, samplesPerBlock, layout);
+            active = none;
+
+            // Relevo: la entrada que retiene el lookahead del motor saliente
+            using Mono = GateEngine<SampleType, 1>;
+            relayBuffer.setSize (layout.size(), juce::jmax (1, Mono::lookaheadMsToSamples (Mono::maxLookaheadMs, sampleRate)));
+
+            // Fundido: copia de la entrada de un bloque para el motor saliente
+            fadeBuffer.setSize (layout.size(), juce::jmax (1, samplesPerBlock));
+            fadeLength = juce::jmax (1, juce::roundToInt (crossfadeMs * 0.001 * sampleRate));
+            fadingOut = none;
+        }
+
+        GateEngine<SampleType, 1> mono;
+        GateEngine<SampleType, 2> stereo;
+        MultichannelGateEngine<SampleType> multichannel;
+        MultibandGateEngine<SampleType> multiband;
+        SpectralGateEngine<SampleType> spectral;
+        Active active = none;
+
+        juce::AudioBuffer<SampleType> relayBuffer;
+
+        // --- Fundido entre motores (cambio de BANDS o MODE) ---
+        // El relevo no basta: los cruces LR4 cambian la fase y la STFT sale en
+        // silencio durante su latencia. El motor saliente sigue procesando una
+        // copia de la entrada hasta que el entrante da salida válida, y después
+        // se funde con él en crossfadeMs.
+        static constexpr double crossfadeMs = 10.0;
+
+        Active fadingOut = none;   // motor saliente (none: sin fundido)
+        int fadePrimed   = 0;      // entrada pendiente con la que se cebó el entrante
+        int fadeHold     = -1;     // muestras antes del fundido (-1: por calcular)
+        int fadeLength   = 1;
+        int fadeElapsed  = 0;      // muestras desde el cambio
+        juce::AudioBuffer<SampleType> fadeBuffer;
+
+        // Key externa: un puntero al sidechain por canal principal (sin copias)
+        std::array<const SampleType*, MultichannelGateEngine<SampleType>::maxChannels> keyChannels {};
+    };
+
+    // Solo existe el conjunto de la precisión en uso: el host la fija antes de
+    // prepareToPlay, que crea ese conjunto y libera el otro
+    std::unique_ptr<GateEngines<float>>  floatEngines;   // processBlock (AudioBuffer<float>&)
+    std::unique_ptr<GateEngines<double>> doubleEngines;  // processBlock (AudioBuffer<double>&)
 
-    // --- Estado del Seguidor de Envolvente (Noise Gate DSP) ---
-    float envelope = 0.0f;  // Envolvente de ganancia suavizada (en dB, valor <= 0)
+    // Cuerpo común de ambos processBlock (misma balística en float y double)
+    template <typename SampleType>
+    void processGate (juce::AudioBuffer<SampleType>& buffer, GateEngines<SampleType>& engines);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SilentRoomAudioProcessor)
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+
+    Sustituye los operator new/delete globales cuando SILENTROOM_REALTIME_GUARD
+    está activo para detectar reservas en el hilo de audio.
+
+    Nota: en ejecutables (herramientas de consola) la sustitución siempre se
+    aplica. Dentro de un plugin cargado por un host, en Windows queda local al
+    módulo; en Linux/macOS el enlazador dinámico puede resolver a la versión
+    del host, y entonces el guard simplemente no ve nada (nunca interfiere).
+    Las variantes alineadas (C++17) no se sustituyen.
+
+  ==============================================================================
+*/
+
+#include "RealtimeGuard.h"
+
+#if SILENTROOM_REALTIME_GUARD
+
+#include <cstdlib>
+#include <new>
+
+namespace RealtimeGuard
+{
+    namespace
+    {
+        thread_local bool realtimeThread = false;
+        std::atomic<juce::uint64> numViolations { 0 };
+    }
+
+    bool isRealtimeThread() noexcept                   { return realtimeThread; }
+    void setRealtimeThread (bool isRealtime) noexcept  { realtimeThread = isRealtime; }
+
+    void reportViolation() noexcept
+    {
+        // Salir del modo tiempo real mientras se informa: jassert puede
+        // registrar el aviso y reservar memoria, y no debe volver a entrar aquí.
+        const bool wasRealtime = realtimeThread;
+        realtimeThread = false;
+
+        numViolations.fetch_add (1, std::memory_order_relaxed);
+        jassertfalse;   // Reserva/liberación o lock dentro de processBlock
+
+        realtimeThread = wasRealtime;
+    }
+
+    juce::uint64 getNumViolations() noexcept
+    {
+        return numViolations.load (std::memory_order_relaxed);
+    }
+
+    static void* allocate (std::size_t size)
+    {
+        if (realtimeThread)
+            reportViolation();
+
+        return std::malloc (size == 0 ? 1 : size);
+    }
+
+    static void deallocate (void* ptr) noexcept
+    {
+        if (ptr != nullptr && realtimeThread)
+            reportViolation();
+
+        std::free (ptr);
+    }
+}
+
+//==============================================================================
+void* operator new (std::size_t size)
+{
+    if (auto* ptr = RealtimeGuard::allocate (size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    return operator new (size);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    return RealtimeGuard::allocate (size);
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+    return RealtimeGuard::allocate (size);
+}
+
+void operator delete (void* ptr) noexcept                          { RealtimeGuard::deallocate (ptr); }
+void operator delete[] (void* ptr) noexcept                        { RealtimeGuard::deallocate (ptr); }
+void operator delete (void* ptr, std::size_t) noexcept             { RealtimeGuard::deallocate (ptr); }
+void operator delete[] (void* ptr, std::size_t) noexcept           { RealtimeGuard::deallocate (ptr); }
+void operator delete (void* ptr, const std::nothrow_t&) noexcept   { RealtimeGuard::deallocate (ptr); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept { RealtimeGuard::deallocate (ptr); }
+
+#endif
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+
+    Vigilancia de tiempo real para builds de depuración: marca el hilo de audio
+    mientras está dentro de processBlock y avisa (jassert + contador) si en ese
+    tramo se reserva o libera memoria del heap o se toma un lock propio.
+
+    Por defecto solo está activo con JUCE_DEBUG; en release todo se reduce a
+    tipos vacíos y funciones inline sin coste.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef SILENTROOM_REALTIME_GUARD
+ #if JUCE_DEBUG
+  #define SILENTROOM_REALTIME_GUARD 1
+ #else
+  #define SILENTROOM_REALTIME_GUARD 0
+ #endif
+#endif
+
+namespace RealtimeGuard
+{
+   #if SILENTROOM_REALTIME_GUARD
+    // Estado del hilo actual (thread_local, definido en RealtimeGuard.cpp)
+    bool isRealtimeThread() noexcept;
+    void setRealtimeThread (bool isRealtime) noexcept;
+
+    // Registra una infracción y dispara un jassert (sin reservar memoria)
+    void reportViolation() noexcept;
+
+    // Infracciones detectadas desde el arranque del proceso
+    juce::uint64 getNumViolations() noexcept;
+
+    // Marca el tramo actual como tiempo real (se puede anidar)
+    struct ScopedRealtimeSection
+    {
+        ScopedRealtimeSection() noexcept   : previous (isRealtimeThread())  { setRealtimeThread (true); }
+        ~ScopedRealtimeSection()                                            { setRealtimeThread (previous); }
+
+        const bool previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRealtimeSection)
+    };
+
+    // Llamar antes de tomar cualquier lock propio del plugin (hoy, el de
+    // SharedResourcePool). Los locks ajenos (host, JUCE, std::mutex directo)
+    // no se pueden interceptar de forma portable.
+    inline void checkLock() noexcept
+    {
+        if (isRealtimeThread())
+            reportViolation();
+    }
+   #else
+    // Constructor propio: sin él, una variable de este tipo vacío que no se
+    // usa dispara -Wunused-variable en release
+    struct ScopedRealtimeSection
+    {
+        ScopedRealtimeSection() noexcept {}
+    };
+
+    inline juce::uint64 getNumViolations() noexcept  { return 0; }
+    inline void checkLock() noexcept                 {}
+   #endif
+}
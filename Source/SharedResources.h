@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    SharedResources.h
+
+    Recursos de solo lectura compartidos por todas las instancias de
+    SilentRoom en el proceso: ventanas del modo espectral,
+    coeficientes del sobremuestreo true peak... Con plantillas de 100+
+    instancias cada tabla se calcula una vez y existe una sola copia.
+
+    SharedResourcePool vive mientras alguna instancia lo use
+    (juce::SharedResourcePointer) y cada recurso mientras algún motor tenga
+    su shared_ptr: el pool solo guarda weak_ptr, así que un tamaño de FFT que
+    ya nadie usa (p. ej. tras cambiar la frecuencia de muestreo) se libera.
+
+    Un recurso es cualquier tipo construible a partir de una clave entera
+    (orden de la FFT, factor de sobremuestreo...) con un método
+    getSizeInBytes(). Una vez creado es inmutable: se puede leer desde
+    cualquier hilo sin sincronización. get() reserva y bloquea: solo en
+    prepare(), nunca en el audio thread (en debug, RealtimeGuard avisa si
+    se toma el lock dentro de processBlock).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <typeindex>
+#include "RealtimeGuard.h"
+
+//==============================================================================
+class SharedResourcePool
+{
+public:
+    struct Stats
+    {
+        int numResources = 0;          // recursos vivos
+        size_t numBytes = 0;           // memoria de esos recursos (una copia por proceso)
+        juce::uint64 numRequests = 0;  // llamadas a get()
+        juce::uint64 numCreated  = 0;  // recursos construidos (el resto, reutilizados)
+    };
+
+    // Devuelve el recurso de tipo Resource para la clave dada; lo construye
+    // (Resource (key)) solo si ninguna instancia lo tiene ya.
+    template <typename Resource>
+    std::shared_ptr<const Resource> get (int key)
+    {
+        RealtimeGuard::checkLock();
+        const juce::ScopedLock sl (lock);
+        ++numRequests;
+
+        const std::type_index type (typeid (Resource));
+
+        for (auto& entry : entries)
+            if (entry.type == type && entry.key == key)
+                if (auto existing = entry.resource.lock())
+                    return std::static_pointer_cast<const Resource> (existing);
+
+        removeExpiredEntries();
+
+        auto created = std::make_shared<const Resource> (key);
+        entries.push_back ({ type, key, created, created->getSizeInBytes() });
+        ++numCreated;
+
+        return created;
+    }
+
+    Stats getStats() const
+    {
+        RealtimeGuard::checkLock();
+        const juce::ScopedLock sl (lock);
+
+        Stats stats;
+        stats.numRequests = numRequests;
+        stats.numCreated  = numCreated;
+
+        for (auto& entry : entries)
+        {
+            if (! entry.resource.expired())
+            {
+                ++stats.numResources;
+                stats.numBytes += entry.numBytes;
+            }
+        }
+
+        return stats;
+    }
+
+private:
+    struct Entry
+    {
+        std::type_index type;
+        int key;
+        std::weak_ptr<const void> resource;
+        size_t numBytes;
+    };
+
+    void removeExpiredEntries()
+    {
+        entries.erase (std::remove_if (entries.begin(), entries.end(),
+                                       [] (const Entry& entry) { return entry.resource.expired(); }),
+                       entries.end());
+    }
+
+    juce::CriticalSection lock;
+    std::vector<Entry> entries;
+    juce::uint64 numRequests = 0;
+    juce::uint64 numCreated  = 0;
+};
@@ -0,0 +1,542 @@
+/*
+  ==============================================================================
+
+    SpectralGateEngine.h
+
+    Modo espectral ("SilentRoom"): puerta por bin de FFT contra un perfil de
+    ruido aprendido. STFT en streaming con juce::dsp::FFT:
+      - Trama de N = 2048 muestras a partir de 88.2 kHz y 1024 por debajo
+        (~21 ms en ambos casos), salto N/4, ventana sqrt-Hann periódica de
+        análisis y de síntesis (Hann al cuadrado con 75 % de solape suma 2:
+        reconstrucción exacta con la ganancia 1/2 en la síntesis).
+      - Latencia: N muestras (getLatencySamples; el procesador la comunica
+        al host con setLatencySamples al entrar o salir del modo).
+
+    Por bin, la curva de rodilla dura de la puerta de dominio temporal: nivel en dB
+    frente a umbral = perfil + SPECTRAL_OFFSET, GR = (nivel - umbral) *
+    (1 - 1/ratio) por debajo del umbral, suelo de RANGE, y balística
+    attack/release por trama (un polo por bin). THRESHOLD, LOOKAHEAD, HOLD,
+    HYSTERESIS, KNEE, la key externa y el detector son del modo temporal y
+    aquí no se usan.
+
+    Perfil de ruido: mientras LEARN está activo se acumula la potencia media
+    de cada bin y canal (cada activación empieza un perfil nuevo) y la salida
+    pasa sin puerta. Sin perfil aprendido el modo es transparente. El perfil
+    es por canal; en modo enlazado (o por grupos) un bin se abre en todos los
+    canales si cualquiera supera su umbral, en modo independiente cada canal
+    tiene su propia envolvente por bin.
+
+    Ruta rápida: si todos los bins de la trama están asentados abiertos (o se
+    está aprendiendo), la salida de la ISTFT es la entrada enventanada, así
+    que se suma directamente sin FFT inversa.
+
+    Recursos compartidos: las ventanas de cada tamaño son inmutables y se
+    comparten entre todas las instancias del proceso (SharedResourcePool,
+    pedidas en prepare()). El plan de FFT no: la implementación por defecto
+    de JUCE (sin IPP, vDSP ni FFTW) toma un SpinLock interno en perform(), y
+    un plan común haría esperar a los hilos de audio de todas las instancias.
+    Cada instancia crea el suyo en prepare().
+
+    Todo el procesado interno es float (juce::dsp::FFT solo existe en float);
+    con SampleType double se convierte al entrar y salir de las tramas.
+    Toda la memoria se reserva en prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "GateEngine.h"
+#include "MultichannelGateEngine.h"
+#include "SharedResources.h"
+
+//==============================================================================
+// Parámetros propios del modo espectral (los comunes van en GateParameters)
+struct SpectralParameters
+{
+    float profileOffsetDb = 12.0f;  // dB por encima del perfil de ruido
+    bool learning = false;          // aprendiendo el perfil (salida sin puerta)
+};
+
+//==============================================================================
+// Ventanas de un tamaño de trama (inmutables una vez creadas). Recurso de
+// SharedResourcePool con el orden de la FFT como clave.
+struct SpectralFrameSetup
+{
+    explicit SpectralFrameSetup (int fftOrder)
+        : order (fftOrder),
+          size (1 << fftOrder),
+          hopSize (size / overlap),
+          numBins (size / 2 + 1),
+          analysisWindow ((size_t) size),
+          synthesisWindow ((size_t) size),
+          overlapAddWindow ((size_t) size)
+    {
+        // sqrt-Hann periódica: análisis * síntesis = Hann, que con 75 % de
+        // solape suma 2 en todas las muestras
+        for (int i = 0; i < size; ++i)
+        {
+            const double hann = 0.5 - 0.5 * std::cos (juce::MathConstants<double>::twoPi * i / size);
+            analysisWindow[(size_t) i]   = (float) std::sqrt (hann);
+            synthesisWindow[(size_t) i]  = (float) (std::sqrt (hann) * 2.0 / overlap);
+            overlapAddWindow[(size_t) i] = analysisWindow[(size_t) i] * synthesisWindow[(size_t) i];
+        }
+    }
+
+    size_t getSizeInBytes() const noexcept
+    {
+        return sizeof (*this) + 3 * (size_t) size * sizeof (float);
+    }
+
+    static constexpr int overlap = 4;
+
+    const int order, size, hopSize, numBins;
+    std::vector<float> analysisWindow;
+    std::vector<float> synthesisWindow;     // incluye la normalización del solape
+    std::vector<float> overlapAddWindow;    // análisis * síntesis (ruta abierta)
+};
+
+//==============================================================================
+template <typename SampleType>
+class SpectralGateEngine
+{
+public:
+    using PathCounts = GatePathCounts;
+    using GainComputer = GateGainComputer<SampleType>;
+
+    static constexpr int maxChannels = MultichannelGateEngine<SampleType>::maxChannels;
+
+    // Orden de la FFT para una frecuencia de muestreo (~21 ms por trama)
+    static int getOrderForSampleRate (double sampleRate) noexcept
+    {
+        return sampleRate >= 88200.0 ? 11 : 10;
+    }
+
+    //==============================================================================
+    void prepare (double newSampleRate, int maximumBlockSize, const juce::AudioChannelSet& layout)
+    {
+        juce::ignoreUnused (maximumBlockSize);
+
+        const int newNumChannels = juce::jlimit (1, maxChannels, layout.size());
+        const int newOrder = getOrderForSampleRate (newSampleRate);
+
+        // El perfil aprendido sobrevive a un prepare con el mismo tamaño de trama
+        const bool keepProfile = setup != nullptr && setup->order == newOrder && newNumChannels == numChannels;
+
+        sampleRate  = newSampleRate;
+        numChannels = newNumChannels;
+        setup = resources->get<SpectralFrameSetup> (newOrder);
+
+        // Plan propio (ver la cabecera): solo se rehace si cambia el tamaño
+        if (fft == nullptr || fft->getSize() != setup->size)
+            fft = std::make_unique<juce::dsp::FFT> (newOrder);
+
+        const int size = setup->size;
+        const int bins = setup->numBins;
+
+        inputFrames.allocate ((size_t) (numChannels * size), true);
+        outputFrames.allocate ((size_t) (numChannels * size), true);
+        spectra.allocate ((size_t) (numChannels * 2 * size), true);
+        levelsDb.allocate ((size_t) (numChannels * bins), true);
+        envelopesDb.allocate ((size_t) (numChannels * bins), true);
+        gains.allocate ((size_t) (numChannels * bins), true);
+        scratch.allocate ((size_t) bins, true);
+
+        if (! keepProfile)
+        {
+            noisePower.allocate ((size_t) (numChannels * bins), true);
+            noiseDb.allocate ((size_t) (numChannels * bins), true);
+            numProfileFrames = 0;
+        }
+
+        cachedAttackMs = cachedReleaseMs = -1.0f;
+        reset();
+    }
+
+    // Vacía las tramas y abre todos los bins. El perfil de ruido se conserva.
+    void reset() noexcept
+    {
+        if (setup == nullptr)
+            return;
+
+        const int size = setup->size;
+        juce::FloatVectorOperations::clear (inputFrames.get(), numChannels * size);
+        juce::FloatVectorOperations::clear (outputFrames.get(), numChannels * size);
+        juce::FloatVectorOperations::clear (envelopesDb.get(), numChannels * setup->numBins);
+
+        hopPosition = 0;
+        lastGR = SampleType (0);
+    }
+
+    // Pendiente, RANGE y balística de GateParameters (umbral, lookahead y detector no aplican)
+    void setParameters (const GateParameters& params) noexcept
+    {
+        slope = 1.0f - 1.0f / juce::jmax (1.0f, params.ratio);
+        rangeFloorDb = juce::jlimit ((float) GainComputer::maxReductionDb(), 0.0f, -params.rangeDb);
+
+        if (setup == nullptr)
+            return;
+
+        // Un paso de la balística por trama: coeficientes para hopSize muestras
+        if (params.attackMs != cachedAttackMs)
+        {
+            cachedAttackMs = params.attackMs;
+            alphaAttack = (float) std::exp (-setup->hopSize / (params.attackMs * 0.001 * sampleRate));
+        }
+
+        if (params.releaseMs != cachedReleaseMs)
+        {
+            cachedReleaseMs = params.releaseMs;
+            alphaRelease = (float) std::exp (-setup->hopSize / (params.releaseMs * 0.001 * sampleRate));
+        }
+    }
+
+    void setSpectralParameters (const SpectralParameters& newSettings) noexcept
+    {
+        // Cada activación de LEARN empieza un perfil nuevo
+        if (newSettings.learning && ! settings.learning)
+            numProfileFrames = 0;
+
+        settings = newSettings;
+    }
+
+    void setLinkMode (GateLinkMode mode) noexcept               { linkMode = mode; }
+    void setFastMathEnabled (bool shouldUseFastMath) noexcept   { fastMath = shouldUseFastMath; }
+
+    bool hasNoiseProfile() const noexcept     { return numProfileFrames > 0; }
+    int getNumChannels() const noexcept       { return numChannels; }
+    int getFrameSize() const noexcept         { return setup != nullptr ? setup->size : 0; }
+    int getLatencySamples() const noexcept    { return getFrameSize(); }
+
+    // GR de banda ancha de la última trama: energía de salida / entrada (dB)
+    SampleType getEnvelope() const noexcept   { return lastGR; }
+
+    void setEnvelope (SampleType newEnvelope) noexcept
+    {
+        if (envelopesDb != nullptr)
+            juce::FloatVectorOperations::fill (envelopesDb.get(), juce::jmin (0.0f, (float) newEnvelope),
+                                               numChannels * setup->numBins);
+    }
+
+    // La entrada pendiente está repartida entre tramas solapadas: en un relevo
+    // no se pasa a otro motor
+    int copyPendingInput (SampleType* const*) const noexcept  { return 0; }
+
+    // Tramas de la última llamada a process(): open = sin FFT inversa
+    // (abierta o aprendiendo), full = con puerta por bin
+    const PathCounts& getLastPathCounts() const noexcept  { return lastPathCounts; }
+
+    //==============================================================================
+    // Procesa in situ los getNumChannels() canales con N muestras de latencia.
+    // keyChannels se ignora (la detección es por bin sobre la propia señal).
+    // Devuelve la GR más profunda de las tramas del bloque.
+    SampleType process (SampleType* const* channels, int numSamples,
+                        const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        juce::ignoreUnused (keyChannels);
+
+        if (setup == nullptr)
+        {
+            jassertfalse; // process() llamado sin prepare()
+            return SampleType (0);
+        }
+
+        const int size = setup->size;
+        const int hop  = setup->hopSize;
+
+        SampleType maxGR = lastGR;
+        lastPathCounts = {};
+
+        for (int start = 0; start < numSamples;)
+        {
+            // Tramo hasta el final del salto actual
+            const int n = juce::jmin (hop - hopPosition, numSamples - start);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* io = channels[ch] + start;
+                copyToFloat (inputFrames.get() + ch * size + (size - hop) + hopPosition, io, n);
+                copyFromFloat (io, outputFrames.get() + ch * size + hopPosition, n);
+            }
+
+            hopPosition += n;
+            start += n;
+
+            if (hopPosition == hop)
+            {
+                hopPosition = 0;
+                processFrame();
+                maxGR = juce::jmin (maxGR, lastGR);
+            }
+        }
+
+        return maxGR;
+    }
+
+    // La STFT no tiene ruta escalar aparte: la referencia es la misma
+    SampleType processReference (SampleType* const* channels, int numSamples,
+                                 const SampleType* const* keyChannels = nullptr) noexcept
+    {
+        return process (channels, numSamples, keyChannels);
+    }
+
+private:
+    //==============================================================================
+    void processFrame() noexcept
+    {
+        const int size = setup->size;
+        const int hop  = setup->hopSize;
+        const int bins = setup->numBins;
+
+        // 1. Análisis: ventana + FFT real de cada canal, y nivel por bin en dB
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* spectrum = spectra.get() + ch * 2 * size;
+            juce::FloatVectorOperations::multiply (spectrum, inputFrames.get() + ch * size, setup->analysisWindow.data(), size);
+            fft->performRealOnlyForwardTransform (spectrum, true);
+
+            computeLevelsDb (spectrum, levelsDb.get() + ch * bins, bins);
+        }
+
+        // 2. Perfil de ruido o GR por bin
+        bool allOpen = true;
+
+        if (settings.learning)
+            learnProfile();
+        else if (hasNoiseProfile() && slope > 0.0f)
+            allOpen = computeGains();
+        else
+            juce::FloatVectorOperations::clear (envelopesDb.get(), numChannels * bins);
+
+        // 3. Síntesis: desplazar la salida un salto y sumar la trama nueva
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* output = outputFrames.get() + ch * size;
+            auto* input  = inputFrames.get() + ch * size;
+
+            std::memmove (output, output + hop, sizeof (float) * (size_t) (size - hop));
+            juce::FloatVectorOperations::clear (output + size - hop, hop);
+
+            if (allOpen)
+            {
+                // Ganancia 1 en todos los bins: la ISTFT devuelve la entrada enventanada
+                juce::FloatVectorOperations::addWithMultiply (output, input, setup->overlapAddWindow.data(), size);
+            }
+            else
+            {
+                auto* spectrum = spectra.get() + ch * 2 * size;
+                applyGains (spectrum, gains.get() + getDetector (ch) * bins, bins);
+
+                fft->performRealOnlyInverseTransform (spectrum);
+                juce::FloatVectorOperations::addWithMultiply (output, spectrum, setup->synthesisWindow.data(), size);
+            }
+
+            std::memmove (input, input + hop, sizeof (float) * (size_t) (size - hop));
+        }
+
+        if (allOpen)
+        {
+            ++lastPathCounts.open;
+            lastGR = SampleType (0);
+        }
+        else
+        {
+            ++lastPathCounts.full;
+        }
+    }
+
+    int getDetector (int channel) const noexcept
+    {
+        return linkMode == GateLinkMode::unlinked ? channel : 0;
+    }
+
+    // levels[k] = 20 log10 |X_k| (suelo -100 dB). Potencia y raíz en bucles
+    // separados sin dependencias entre bins: el compilador los vectoriza.
+    void computeLevelsDb (const float* spectrum, float* levels, int bins) noexcept
+    {
+        for (int k = 0; k < bins; ++k)
+        {
+            const float re = spectrum[2 * k];
+            const float im = spectrum[2 * k + 1];
+            scratch[k] = re * re + im * im;
+        }
+
+        for (int k = 0; k < bins; ++k)
+            scratch[k] = std::sqrt (juce::jmax (scratch[k], (float) (GainComputer::minLinearLevel() * GainComputer::minLinearLevel())));
+
+        if (fastMath)
+        {
+            FastMath::gainToDecibels (levels, scratch.get(), bins);
+        }
+        else
+        {
+            for (int k = 0; k < bins; ++k)
+                levels[k] = juce::Decibels::gainToDecibels (scratch[k], (float) GainComputer::minusInfinityDb());
+        }
+    }
+
+    // Media de la potencia por bin y canal (media móvil acumulativa: estable
+    // en float con miles de tramas) y su nivel en dB
+    void learnProfile() noexcept
+    {
+        const int size = setup->size;
+        const int bins = setup->numBins;
+        const float weight = 1.0f / (float) (numProfileFrames + 1);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* spectrum = spectra.get() + ch * 2 * size;
+            auto* power = noisePower.get() + ch * bins;
+            auto* powerDb = noiseDb.get() + ch * bins;
+
+            for (int k = 0; k < bins; ++k)
+            {
+                const float framePower = spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1];
+                power[k] = numProfileFrames == 0 ? framePower : power[k] + weight * (framePower - power[k]);
+
+                // 10 log10 (potencia), con el mismo suelo que el nivel por bin
+                powerDb[k] = 0.5f * juce::Decibels::gainToDecibels (power[k], 2.0f * (float) GainComputer::minusInfinityDb());
+            }
+        }
+
+        ++numProfileFrames;
+        juce::FloatVectorOperations::clear (envelopesDb.get(), numChannels * bins);
+    }
+
+    // GR objetivo, balística y ganancia lineal de cada bin y detector.
+    // Devuelve true si todos los bins están asentados abiertos.
+    bool computeGains() noexcept
+    {
+        const int bins = setup->numBins;
+        const int numDetectors = linkMode == GateLinkMode::unlinked ? numChannels : 1;
+        const float offset = settings.profileOffsetDb;
+        const float floorDb = rangeFloorDb;
+
+        float minEnvelope = 0.0f;
+
+        for (int d = 0; d < numDetectors; ++d)
+        {
+            // Exceso sobre el umbral (dB); enlazado: el mayor de todos los canales
+            const int firstChannel = numDetectors == 1 ? 0 : d;
+            const int lastChannel  = numDetectors == 1 ? numChannels : d + 1;
+
+            for (int k = 0; k < bins; ++k)
+                scratch[k] = levelsDb[firstChannel * bins + k] - noiseDb[firstChannel * bins + k] - offset;
+
+            for (int ch = firstChannel + 1; ch < lastChannel; ++ch)
+                for (int k = 0; k < bins; ++k)
+                    scratch[k] = juce::jmax (scratch[k], levelsDb[ch * bins + k] - noiseDb[ch * bins + k] - offset);
+
+            // GR objetivo y balística sin saltos: selecciones que se vectorizan
+            auto* envelope = envelopesDb.get() + d * bins;
+
+            for (int k = 0; k < bins; ++k)
+            {
+                const float target = juce::jmax (floorDb, juce::jmin (0.0f, scratch[k]) * slope);
+                const float alpha  = target > envelope[k] ? alphaAttack : alphaRelease;
+                envelope[k] = target + alpha * (envelope[k] - target);
+                minEnvelope = juce::jmin (minEnvelope, envelope[k]);
+            }
+        }
+
+        if (minEnvelope >= (float) GainComputer::settledOpenDb)
+        {
+            lastGR = SampleType (0);
+            return true;
+        }
+
+        // Ganancia lineal y GR de banda ancha (energía ponderada por bin)
+        double inputEnergy = 0.0, outputEnergy = 0.0;
+
+        for (int d = 0; d < numDetectors; ++d)
+        {
+            auto* dGains = gains.get() + d * bins;
+            const auto* envelope = envelopesDb.get() + d * bins;
+
+            if (fastMath)
+                FastMath::decibelsToGain (dGains, envelope, bins);
+            else
+                for (int k = 0; k < bins; ++k)
+                    dGains[k] = juce::Decibels::decibelsToGain (envelope[k], floorDb);
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* spectrum = spectra.get() + ch * 2 * setup->size;
+            const auto* chGains  = gains.get() + getDetector (ch) * bins;
+
+            for (int k = 0; k < bins; ++k)
+            {
+                const float power = spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1];
+                inputEnergy  += power;
+                outputEnergy += power * chGains[k] * chGains[k];
+            }
+        }
+
+        lastGR = inputEnergy > 0.0 ? (SampleType) juce::jmax ((double) floorDb, 10.0 * std::log10 (juce::jmax (1.0e-30, outputEnergy / inputEnergy)))
+                                   : SampleType (0);
+        return false;
+    }
+
+    // Multiplica re/im de cada bin por su ganancia
+    static void applyGains (float* spectrum, const float* binGains, int bins) noexcept
+    {
+        for (int k = 0; k < bins; ++k)
+        {
+            spectrum[2 * k]     *= binGains[k];
+            spectrum[2 * k + 1] *= binGains[k];
+        }
+    }
+
+    static void copyToFloat (float* dest, const SampleType* src, int n) noexcept
+    {
+        if constexpr (std::is_same<SampleType, float>::value)
+            juce::FloatVectorOperations::copy (dest, src, n);
+        else
+            for (int i = 0; i < n; ++i)
+                dest[i] = (float) src[i];
+    }
+
+    static void copyFromFloat (SampleType* dest, const float* src, int n) noexcept
+    {
+        if constexpr (std::is_same<SampleType, float>::value)
+            juce::FloatVectorOperations::copy (dest, src, n);
+        else
+            for (int i = 0; i < n; ++i)
+                dest[i] = (SampleType) src[i];
+    }
+
+    //==============================================================================
+    juce::SharedResourcePointer<SharedResourcePool> resources;
+    std::shared_ptr<const SpectralFrameSetup> setup;
+    std::unique_ptr<juce::dsp::FFT> fft;
+
+    double sampleRate = 44100.0;
+    int numChannels   = 1;
+    int hopPosition   = 0;
+    int numProfileFrames = 0;
+
+    SpectralParameters settings;
+    GateLinkMode linkMode = GateLinkMode::linked;
+    bool fastMath = false;
+
+    float slope = 0.0f;
+    float rangeFloorDb = (float) GainComputer::maxReductionDb();   // suelo de la GR con RANGE
+    float alphaAttack = 0.0f, alphaRelease = 0.0f;
+    float cachedAttackMs = -1.0f, cachedReleaseMs = -1.0f;
+
+    SampleType lastGR = SampleType (0);
+    PathCounts lastPathCounts;
+
+    // --- Buffers (reservados en prepare) ---
+    juce::HeapBlock<float> inputFrames;    // [canal][N]: últimas N muestras de entrada
+    juce::HeapBlock<float> outputFrames;   // [canal][N]: acumulador del overlap-add
+    juce::HeapBlock<float> spectra;        // [canal][2N]: trama / espectro (re, im)
+    juce::HeapBlock<float> levelsDb;       // [canal][bin]
+    juce::HeapBlock<float> envelopesDb;    // [detector][bin]: GR suavizada
+    juce::HeapBlock<float> gains;          // [detector][bin]: ganancia lineal
+    juce::HeapBlock<float> noisePower;     // [canal][bin]: potencia media del ruido
+    juce::HeapBlock<float> noiseDb;        // [canal][bin]: perfil en dB (10 log10)
+    juce::HeapBlock<float> scratch;        // [bin]
+};
@@ -0,0 +1,1063 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    SilentRoomBatch: aplica la puerta de SilentRoom a muchos ficheros de audio
+    sin DAW. Lee WAV/AIFF/FLAC en bloques grandes, reparte los ficheros en un
+    pool de hilos con robo de trabajo y escribe el resultado en streaming
+    (nunca se carga un fichero completo en memoria).
+
+    Con --analyse solo estima el suelo de ruido y el umbral sugerido de cada
+    fichero; con --auto-threshold lo estima y lo usa como THRESHOLD antes de
+    procesarlo. El análisis lee WAV/AIFF proyectados en memoria
+    (MemoryMappedAudioFormatReader) y el resto en streaming.
+
+    Con --index, cada fichero de banda ancha mono o estéreo enlazado guarda un
+    índice de detección (GateDetectorIndex.h) junto al original. Los lotes
+    siguientes que solo cambian THRESHOLD, RATIO, ATTACK, RELEASE, HOLD,
+    HYSTERESIS, KNEE o RANGE renderizan desde el índice sin repetir la
+    detección, y los ficheros cuya salida ya corresponde a los parámetros
+    actuales se saltan.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/NoiseFloorAnalyser.h"
+#include "../../../Source/GateDetectorIndex.h"
+#include "WorkStealingPool.h"
+
+namespace
+{
+    //==============================================================================
+    struct BatchOptions
+    {
+        juce::Array<juce::File> inputs;
+        juce::File outputFolder;                    // vacío = junto al original
+        juce::String suffix { "_gated" };
+        juce::File presetFile;                      // estado guardado por el plugin (binario o XML)
+        juce::String program;                       // programa de fábrica (número o nombre)
+        juce::File statsFile;                       // JSON con el tiempo por bloque
+        juce::StringPairArray parameterOverrides;   // ID -> valor (unidades reales)
+        double learnSeconds = 0.0;                  // perfil de ruido del modo espectral
+        int blockSize  = 65536;
+        int numThreads = juce::SystemStats::getNumCpus();
+        bool recursive = false;
+        bool fastMath  = false;                     // kernels dB aproximados (FastMath.h)
+        bool analyseOnly   = false;                 // solo estimar el suelo de ruido
+        bool autoThreshold = false;                 // THRESHOLD = suelo de ruido + AUTO_MARGIN
+        bool useIndex = false;                      // índice de detección por fichero
+        juce::File indexFolder;                     // vacío = .silentroom-index junto al original
+    };
+
+    // Cómo se ha procesado un fichero con --index
+    enum class IndexUse { none, built, reused, unchanged };
+
+    struct FileResult
+    {
+        bool ok = false;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double wallSeconds  = 0.0;
+
+        // Análisis del suelo de ruido (--analyse / --auto-threshold)
+        bool hasNoiseFloor = false;
+        float noiseFloorDb = 0.0f;
+        float thresholdDb  = 0.0f;
+
+        IndexUse indexUse = IndexUse::none;
+    };
+
+    // Contexto por worker: cada hilo tiene su propio procesador y buffers,
+    // creados en el hilo principal antes de arrancar el pool.
+    struct WorkerContext
+    {
+        juce::AudioFormatManager formatManager;
+        std::unique_ptr<SilentRoomAudioProcessor> processor;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+
+        // THRESHOLD de las opciones: con --auto-threshold, el de los ficheros
+        // sin estimación de ruido (el contexto se reutiliza entre ficheros)
+        float configuredThresholdDb = 0.0f;
+
+        // --- Render desde el índice de detección (--index) ---
+        GateEngine<float, 1> monoDetector;
+        GateEngine<float, 2> stereoDetector;
+        juce::HeapBlock<float> scratch;             // niveles al indexar, ganancias al renderizar
+        GatePathCounts indexPathCounts;             // rutas rápidas de los renders desde el índice
+    };
+
+    static const char* const kAudioWildcard = "*.wav;*.aif;*.aiff;*.flac";
+
+    //==============================================================================
+    void printUsage()
+    {
+        std::cout << "SilentRoomBatch - puerta de ruido SilentRoom por lotes\n\n"
+                     "Uso: SilentRoomBatch [opciones] <ficheros o carpetas...>\n\n"
+                     "  --list <fichero>      lista de rutas (una por línea)\n"
+                     "  --recursive           recorrer subcarpetas\n"
+                     "  --output <carpeta>    carpeta de salida (por defecto, junto al original)\n"
+                     "  --suffix <texto>      sufijo del fichero de salida (por defecto \"_gated\")\n"
+                     "  --preset <fichero>    estado guardado por el plugin (binario o XML)\n"
+                     "  --program <n|nombre>  programa de fábrica (se aplica antes que --preset)\n"
+                     "  --threshold <dB>      --ratio <N>  --attack <ms>  --release <ms>\n"
+                     "  --lookahead <ms>      anticipación (la latencia se compensa en la salida)\n"
+                     "  --hold <ms>           tiempo que la puerta sigue abierta tras bajar del umbral\n"
+                     "  --hysteresis <dB>     distancia bajo el umbral a la que cierra una puerta abierta\n"
+                     "  --knee <dB>           ancho de la rodilla suave alrededor del umbral (0 = dura)\n"
+                     "  --range <dB>          atenuación máxima de la puerta cerrada (por defecto 100)\n"
+                     "  --link <modo>         enlace de canales: linked, unlinked o grouped\n"
+                     "  --key-filter <tipo>   filtro de detección: off, highpass, lowpass o bandpass\n"
+                     "  --key-freq <Hz>       frecuencia del filtro de detección\n"
+                     "  --detector <modo>     detector de nivel: peak, rms o truepeak\n"
+                     "  --rms-window <ms>     ventana del detector RMS\n"
+                     "  --bands <n>           número de bandas (1 = banda ancha, hasta 4)\n"
+                     "  --xover <Hz,Hz,Hz>    frecuencias de cruce, de grave a agudo\n"
+                     "  --band-threshold <dB,...>  --band-ratio <N,...>  umbral y ratio por banda\n"
+                     "  --mode <modo>         gate (dominio temporal) o spectral (por bin de FFT)\n"
+                     "  --spectral-offset <dB>  umbral por bin sobre el perfil de ruido\n"
+                     "  --learn <s>           aprender el perfil de ruido con los primeros s segundos de cada fichero\n"
+                     "  --analyse             solo estimar el suelo de ruido y el umbral sugerido (no escribe audio)\n"
+                     "  --auto-threshold      estimar el suelo de ruido de cada fichero y usarlo como umbral\n"
+                     "  --auto-margin <dB>    margen del umbral sobre el suelo de ruido (por defecto 6)\n"
+                     "  --index               guardar la detección de cada fichero y re-renderizar desde ella\n"
+                     "  --index-folder <carpeta>  carpeta de los índices (por defecto .silentroom-index junto al original)\n"
+                     "  --block <muestras>    tamaño de bloque (por defecto 65536)\n"
+                     "  --threads <n>         hilos de trabajo (por defecto, núcleos de la CPU)\n"
+                     "  --fast-math           usar los kernels dB aproximados de FastMath (por defecto, log10/pow exactos)\n"
+                     "  --stats <json>        exportar el tiempo por bloque (histograma, p99, peor caso)\n";
+    }
+
+    bool parseArguments (const juce::StringArray& args, BatchOptions& options, juce::String& error)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto arg = args[i];
+
+            if (! arg.startsWith ("--"))
+            {
+                options.inputs.add (juce::File::getCurrentWorkingDirectory().getChildFile (arg));
+                continue;
+            }
+
+            // Admite "--nombre valor" y "--nombre=valor" (los valores pueden ser negativos)
+            const auto name = arg.substring (2).upToFirstOccurrenceOf ("=", false, false);
+            juce::String value;
+
+            auto takeValue = [&]
+            {
+                if (arg.containsChar ('='))
+                    value = arg.fromFirstOccurrenceOf ("=", false, false);
+                else if (i + 1 < args.size())
+                    value = args[++i];
+                else
+                    return false;
+
+                return true;
+            };
+
+            if (name == "recursive")   { options.recursive = true; continue; }
+            if (name == "fast-math")   { options.fastMath = true; continue; }
+            if (name == "exact-math")  { options.fastMath = false; continue; }
+            if (name == "analyse")     { options.analyseOnly = true; continue; }
+            if (name == "auto-threshold") { options.autoThreshold = true; continue; }
+            if (name == "index")       { options.useIndex = true; continue; }
+
+            if (! takeValue())
+            {
+                error = "Falta el valor de --" + name;
+                return false;
+            }
+
+            const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+            if (name == "output")        options.outputFolder = cwd.getChildFile (value);
+            else if (name == "suffix")   options.suffix = value;
+            else if (name == "preset")   options.presetFile = cwd.getChildFile (value);
+            else if (name == "program")  options.program = value;
+            else if (name == "stats")    options.statsFile = cwd.getChildFile (value);
+            else if (name == "index-folder")
+            {
+                options.indexFolder = cwd.getChildFile (value);
+                options.useIndex = true;
+            }
+            else if (name == "block")    options.blockSize = juce::jlimit (256, 1 << 20, value.getIntValue());
+            else if (name == "threads")  options.numThreads = juce::jmax (1, value.getIntValue());
+            else if (name == "threshold" || name == "ratio" || name == "attack" || name == "release"
+                  || name == "lookahead" || name == "hold" || name == "hysteresis" || name == "knee"
+                  || name == "range")
+                options.parameterOverrides.set (name.toUpperCase(), value);
+            else if (name == "key-freq")
+                options.parameterOverrides.set ("KEY_FREQ", value);
+            else if (name == "rms-window")
+                options.parameterOverrides.set ("RMS_WINDOW", value);
+            else if (name == "spectral-offset")
+                options.parameterOverrides.set ("SPECTRAL_OFFSET", value);
+            else if (name == "auto-margin")
+                options.parameterOverrides.set ("AUTO_MARGIN", value);
+            else if (name == "learn")
+                options.learnSeconds = juce::jmax (0.0, value.getDoubleValue());
+            else if (name == "mode")
+            {
+                const auto index = juce::StringArray { "gate", "spectral" }.indexOf (value.toLowerCase());
+
+                if (index < 0)
+                {
+                    error = "Modo desconocido: " + value;
+                    return false;
+                }
+
+                options.parameterOverrides.set ("MODE", juce::String (index));
+            }
+            else if (name == "bands")
+            {
+                const auto numBands = value.getIntValue();
+
+                if (numBands < 1 || numBands > 4)
+                {
+                    error = "Número de bandas fuera de rango (1-4): " + value;
+                    return false;
+                }
+
+                options.parameterOverrides.set ("BANDS", juce::String (numBands - 1));
+            }
+            else if (name == "xover" || name == "band-threshold" || name == "band-ratio")
+            {
+                // Lista separada por comas: un valor por corte o por banda
+                const auto values = juce::StringArray::fromTokens (value, ",", {});
+                const auto prefix = name == "xover" ? juce::String ("XOVER_")
+                                  : name == "band-threshold" ? juce::String ("THRESHOLD_B")
+                                                             : juce::String ("RATIO_B");
+                const int maxValues = name == "xover" ? 3 : 4;
+
+                if (values.isEmpty() || values.size() > maxValues)
+                {
+                    error = "--" + name + " admite de 1 a " + juce::String (maxValues) + " valores";
+                    return false;
+                }
+
+                for (int k = 0; k < values.size(); ++k)
+                    options.parameterOverrides.set (prefix + juce::String (k + 1), values[k].trim());
+            }
+            else if (name == "detector")
+            {
+                const auto index = juce::StringArray { "peak", "rms", "truepeak" }.indexOf (value.toLowerCase());
+
+                if (index < 0)
+                {
+                    error = "Detector desconocido: " + value;
+                    return false;
+                }
+
+                options.parameterOverrides.set ("DETECTOR", juce::String (index));
+            }
+            else if (name == "key-filter")
+            {
+                const auto index = juce::StringArray { "off", "highpass", "lowpass", "bandpass" }.indexOf (value.toLowerCase());
+
+                if (index < 0)
+                {
+                    error = "Filtro de detección desconocido: " + value;
+                    return false;
+                }
+
+                options.parameterOverrides.set ("KEY_FILTER", juce::String (index));
+            }
+            else if (name == "link")
+            {
+                const auto index = juce::StringArray { "linked", "unlinked", "grouped" }.indexOf (value.toLowerCase());
+
+                if (index < 0)
+                {
+                    error = "Modo de enlace desconocido: " + value;
+                    return false;
+                }
+
+                options.parameterOverrides.set ("LINK", juce::String (index));
+            }
+            else if (name == "list")
+            {
+                juce::StringArray lines;
+                cwd.getChildFile (value).readLines (lines);
+
+                for (auto& line : lines)
+                    if (line.trim().isNotEmpty())
+                        options.inputs.add (cwd.getChildFile (line.trim()));
+            }
+            else
+            {
+                error = "Opción desconocida: " + arg;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    juce::Array<juce::File> collectInputFiles (const BatchOptions& options)
+    {
+        juce::Array<juce::File> files;
+
+        for (auto& input : options.inputs)
+        {
+            if (input.isDirectory())
+                files.addArray (input.findChildFiles (juce::File::findFiles, options.recursive, kAudioWildcard));
+            else if (input.existsAsFile())
+                files.add (input);
+            else
+                std::cerr << "No existe: " << input.getFullPathName() << "\n";
+        }
+
+        // Al escribir junto al original, no volver a procesar salidas anteriores
+        if (options.outputFolder == juce::File())
+            files.removeIf ([&] (const juce::File& f) { return f.getFileNameWithoutExtension().endsWith (options.suffix); });
+
+        return files;
+    }
+
+    juce::File getOutputFile (const juce::File& input, const BatchOptions& options)
+    {
+        const auto name = input.getFileNameWithoutExtension() + options.suffix + input.getFileExtension();
+
+        return options.outputFolder == juce::File() ? input.getSiblingFile (name)
+                                                    : options.outputFolder.getChildFile (name);
+    }
+
+    // Un índice por fichero de entrada; el hash de la ruta completa evita
+    // colisiones entre ficheros homónimos de carpetas distintas
+    juce::File getIndexFile (const juce::File& input, const BatchOptions& options)
+    {
+        const auto folder = options.indexFolder != juce::File() ? options.indexFolder
+                                                                : input.getSiblingFile (".silentroom-index");
+
+        return folder.getChildFile (input.getFileNameWithoutExtension() + "-"
+                                    + juce::String::toHexString (input.getFullPathName().hashCode64()) + ".srdx");
+    }
+
+    //==============================================================================
+    bool applyParameters (SilentRoomAudioProcessor& processor, const BatchOptions& options, juce::String& error)
+    {
+        if (options.program.isNotEmpty())
+        {
+            int index = options.program.containsOnly ("0123456789") ? options.program.getIntValue() : -1;
+
+            for (int p = 0; index < 0 && p < processor.getNumPrograms(); ++p)
+                if (processor.getProgramName (p).equalsIgnoreCase (options.program))
+                    index = p;
+
+            if (! juce::isPositiveAndBelow (index, processor.getNumPrograms()))
+            {
+                error = "Programa desconocido: " + options.program;
+                return false;
+            }
+
+            processor.setCurrentProgram (index);
+        }
+
+        if (options.presetFile != juce::File())
+        {
+            juce::MemoryBlock data;
+
+            if (! options.presetFile.loadFileAsData (data)
+                || ! processor.restoreState (data.getData(), (int) data.getSize()))
+            {
+                error = "Preset no válido: " + options.presetFile.getFullPathName();
+                return false;
+            }
+        }
+
+        for (auto& paramID : options.parameterOverrides.getAllKeys())
+        {
+            auto* param = processor.apvts.getParameter (paramID);
+
+            if (param == nullptr)
+            {
+                error = "Parámetro desconocido: " + paramID;
+                return false;
+            }
+
+            param->setValueNotifyingHost (param->convertTo0to1 (options.parameterOverrides[paramID].getFloatValue()));
+        }
+
+        processor.setFastMathEnabled (options.fastMath);
+        return true;
+    }
+
+    //==============================================================================
+    // Estima el suelo de ruido del fichero completo (sin olvido) y el umbral
+    // con el AUTO_MARGIN del procesador. WAV y AIFF se leen proyectados en
+    // memoria: sin llamadas al sistema por bloque ni copia en la caché de
+    // ficheros del proceso; el resto de formatos, en streaming.
+    bool analyseNoiseFloor (WorkerContext& ctx, const juce::File& input, int blockSize, FileResult& result)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader;
+
+        if (auto* format = ctx.formatManager.findFormatForFileExtension (input.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (input));
+
+            if (mapped != nullptr && mapped->mapEntireFile())
+                reader = std::move (mapped);
+        }
+
+        if (reader == nullptr)
+            reader.reset (ctx.formatManager.createReaderFor (input));
+
+        if (reader == nullptr)
+        {
+            result.error = "formato no soportado";
+            return false;
+        }
+
+        const int numChannels = (int) reader->numChannels;
+        const auto length     = reader->lengthInSamples;
+
+        NoiseFloorAnalyser analyser;
+        analyser.prepare (reader->sampleRate);
+
+        for (juce::int64 pos = 0; pos < length; pos += blockSize)
+        {
+            const int numSamples = (int) juce::jmin ((juce::int64) blockSize, length - pos);
+
+            ctx.buffer.setSize (numChannels, numSamples, false, false, true);
+            reader->read (&ctx.buffer, 0, numSamples, pos, true, true);
+
+            analyser.process (ctx.buffer.getArrayOfReadPointers(), numChannels, numSamples);
+        }
+
+        // Ficheros muy cortos o en silencio: se conserva el umbral configurado
+        result.hasNoiseFloor = analyser.hasEstimate();
+
+        if (result.hasNoiseFloor)
+        {
+            const float marginDb = ctx.processor->apvts.getRawParameterValue ("AUTO_MARGIN")->load();
+
+            result.noiseFloorDb = analyser.getQuantileDb();
+            result.thresholdDb  = SilentRoomAudioProcessor::noiseFloorToThresholdDb (result.noiseFloorDb, marginDb);
+        }
+
+        result.ok = true;
+        result.audioSeconds = (double) length / reader->sampleRate;
+        return true;
+    }
+
+    //==============================================================================
+    // Escritor en streaming con el formato, la resolución y los metadatos de la entrada
+    std::unique_ptr<juce::AudioFormatWriter> createOutputWriter (juce::AudioFormat& format, const juce::AudioFormatReader& reader,
+                                                                 const juce::File& output, juce::String& error)
+    {
+        output.deleteFile();
+        auto fileStream = std::make_unique<juce::FileOutputStream> (output);
+
+        if (! fileStream->openedOk())
+        {
+            error = "no se puede escribir " + output.getFullPathName();
+            return {};
+        }
+
+        std::unique_ptr<juce::OutputStream> stream (std::move (fileStream));
+
+        const auto sampleFormat = reader.usesFloatingPointData ? juce::AudioFormatWriterOptions::SampleFormat::floatingPoint
+                                                               : juce::AudioFormatWriterOptions::SampleFormat::integral;
+
+        auto writer = format.createWriterFor (stream, juce::AudioFormatWriterOptions{}
+                                                          .withSampleRate (reader.sampleRate)
+                                                          .withNumChannels ((int) reader.numChannels)
+                                                          .withBitsPerSample ((int) reader.bitsPerSample)
+                                                          .withSampleFormat (sampleFormat)
+                                                          .withMetadataValues (reader.metadataValues));
+
+        if (writer == nullptr)
+            error = "no se puede crear el escritor de audio";
+
+        return writer;
+    }
+
+    //==============================================================================
+    // THRESHOLD de este fichero: el estimado si lo hay y, si no, el configurado
+    // (nunca el del fichero anterior que procesó el mismo contexto)
+    void setFileThreshold (WorkerContext& ctx, const FileResult& result)
+    {
+        auto* threshold = ctx.processor->apvts.getParameter ("THRESHOLD");
+        const float thresholdDb = result.hasNoiseFloor ? result.thresholdDb : ctx.configuredThresholdDb;
+        threshold->setValueNotifyingHost (threshold->convertTo0to1 (thresholdDb));
+    }
+
+    FileResult processFile (WorkerContext& ctx, const juce::File& input, const juce::File& output, int blockSize,
+                            double learnSeconds, bool autoThreshold)
+    {
+        FileResult result;
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        // --- Umbral por fichero a partir de su suelo de ruido ---
+        // Sustituye al umbral automático del procesador (que necesita ~1 s de
+        // señal para estimarlo y arrancaría con el umbral manual)
+        if (autoThreshold)
+        {
+            if (! analyseNoiseFloor (ctx, input, blockSize, result))
+                return result;
+
+            result.ok = false;
+            ctx.processor->apvts.getParameter ("AUTO_THRESHOLD")->setValueNotifyingHost (0.0f);
+            setFileThreshold (ctx, result);
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader (ctx.formatManager.createReaderFor (input));
+        auto* format = ctx.formatManager.findFormatForFileExtension (input.getFileExtension());
+
+        if (reader == nullptr || format == nullptr)
+        {
+            result.error = "formato no soportado";
+            return result;
+        }
+
+        const int numChannels   = (int) reader->numChannels;
+        const double sampleRate = reader->sampleRate;
+
+        if (numChannels < 1 || numChannels > MultichannelGateEngine<float>::maxChannels)
+        {
+            result.error = "número de canales no soportado";
+            return result;
+        }
+
+        // --- Escritor en streaming ---
+        auto writer = createOutputWriter (*format, *reader, output, result.error);
+
+        if (writer == nullptr)
+            return result;
+
+        // --- Configurar el procesador para este fichero ---
+        auto& processor = *ctx.processor;
+
+        // Disposición del fichero (máscara de canales del WAV) para el modo grouped
+        auto channelSet = reader->getChannelLayout();
+
+        if (channelSet.size() != numChannels)
+            channelSet = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+
+        // Bus principal con la disposición del fichero; sidechain desactivado
+        auto layout = processor.getBusesLayout();
+        layout.inputBuses.getReference (0)  = channelSet;
+        layout.outputBuses.getReference (0) = channelSet;
+
+        for (int bus = 1; bus < layout.inputBuses.size(); ++bus)
+            layout.inputBuses.getReference (bus) = juce::AudioChannelSet::disabled();
+
+        if (! processor.setBusesLayout (layout))
+        {
+            result.error = "disposición de canales no soportada";
+            return result;
+        }
+
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+        ctx.buffer.setSize (numChannels, blockSize, false, false, true);
+
+        // --- Perfil de ruido del modo espectral ---
+        // Primera pasada sobre el comienzo del fichero con LEARN activo (cada
+        // activación empieza un perfil nuevo); su salida se descarta.
+        if (learnSeconds > 0.0)
+        {
+            auto* learn = processor.apvts.getParameter ("LEARN");
+            const auto learnLength = juce::jmin (reader->lengthInSamples, (juce::int64) (learnSeconds * sampleRate));
+
+            learn->setValueNotifyingHost (1.0f);
+
+            for (juce::int64 pos = 0; pos < learnLength; pos += blockSize)
+            {
+                const int numSamples = (int) juce::jmin ((juce::int64) blockSize, learnLength - pos);
+
+                ctx.buffer.setSize (numChannels, numSamples, false, false, true);
+                reader->read (&ctx.buffer, 0, numSamples, pos, true, true);
+
+                ctx.midi.clear();
+                processor.processBlock (ctx.buffer, ctx.midi);
+            }
+
+            learn->setValueNotifyingHost (0.0f);
+
+            // Vaciar tramas y envolventes antes de la pasada real (el perfil se conserva)
+            processor.prepareToPlay (sampleRate, blockSize);
+        }
+
+        // --- Bucle de streaming: leer, procesar y escribir por bloques ---
+        // La latencia (lookahead o trama espectral) se compensa descartando las
+        // primeras muestras de salida y vaciando la línea de retardo con
+        // silencio al final.
+        const auto length  = reader->lengthInSamples;
+        const int latency  = processor.getLatencySamples();
+        juce::int64 toSkip = latency;
+
+        auto processAndWrite = [&] (int numSamples)
+        {
+            ctx.midi.clear();
+            processor.processBlock (ctx.buffer, ctx.midi);
+
+            const int skipped = (int) juce::jmin (toSkip, (juce::int64) numSamples);
+            toSkip -= skipped;
+
+            return writer->writeFromAudioSampleBuffer (ctx.buffer, skipped, numSamples - skipped);
+        };
+
+        for (juce::int64 pos = 0; pos < length + latency; pos += blockSize)
+        {
+            const int numSamples = (int) juce::jmin ((juce::int64) blockSize, length + latency - pos);
+
+            ctx.buffer.setSize (numChannels, numSamples, false, false, true);
+            ctx.buffer.clear();
+
+            if (pos < length)
+                reader->read (&ctx.buffer, 0, (int) juce::jmin ((juce::int64) numSamples, length - pos), pos, true, true);
+
+            if (! processAndWrite (numSamples))
+            {
+                result.error = "error de escritura";
+                return result;
+            }
+        }
+
+        writer.reset();   // cierra y vuelca la cabecera
+        processor.releaseResources();
+
+        result.ok = true;
+        result.audioSeconds = (double) length / sampleRate;
+        result.wallSeconds  = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+        return result;
+    }
+
+    //==============================================================================
+    // --- Render desde el índice de detección (--index) ---
+    // Solo la puerta de banda ancha con un único grupo de detección (mono o
+    // estéreo enlazado, sin umbral automático del procesador): es la ruta de
+    // GateEngine que el índice reproduce. El resto va por processFile.
+    bool canUseIndex (SilentRoomAudioProcessor& processor, int numChannels)
+    {
+        auto value = [&] (const char* paramID)  { return juce::roundToInt (processor.apvts.getRawParameterValue (paramID)->load()); };
+
+        return value ("MODE") == 0 && value ("BANDS") == 0 && value ("AUTO_THRESHOLD") == 0
+            && (numChannels == 1 || (numChannels == 2 && value ("LINK") == (int) GateLinkMode::linked));
+    }
+
+    juce::uint64 hashKey (const juce::String& text)   { return (juce::uint64) text.hashCode64(); }
+
+    // Fichero fuente: ruta, tamaño y fecha de modificación
+    juce::uint64 getSourceKey (const juce::File& input)
+    {
+        return hashKey (input.getFullPathName() + "|" + juce::String (input.getSize())
+                        + "|" + juce::String (input.getLastModificationTime().toMilliseconds()));
+    }
+
+    // Todo lo que cambia los niveles guardados en el índice
+    juce::uint64 getDetectorKey (const GateParameters& params, double sampleRate, int numChannels, int latency, bool fastMath)
+    {
+        juce::String key;
+        key << sampleRate << "|" << numChannels << "|" << latency << "|" << (int) fastMath
+            << "|" << (int) params.detector << "|" << (int) params.keyFilter;
+
+        if (params.keyFilter != KeyFilterMode::off)
+            key << "|" << params.keyFrequencyHz;
+
+        if (params.detector == DetectorMode::rms)
+            key << "|" << params.rmsWindowMs;
+
+        return hashKey (key);
+    }
+
+    // Salida y todos los parámetros del procesador (con el umbral ya resuelto)
+    juce::uint64 getRenderKey (SilentRoomAudioProcessor& processor, const juce::File& output)
+    {
+        juce::String key (output.getFullPathName());
+
+        for (auto* param : processor.getParameters())
+            key << "|" << param->getValue();
+
+        key << "|" << (int) processor.isFastMathEnabled();
+        return hashKey (key);
+    }
+
+    // Primera pasada: detección completa del fichero (más L muestras de
+    // silencio, como el vaciado del lookahead) y su suelo de ruido. El
+    // detector del número de canales del fichero ya está preparado.
+    bool buildIndex (WorkerContext& ctx, juce::AudioFormatReader& reader, const juce::File& indexFile,
+                     const GateDetectorIndex::Header& header, int blockSize, bool fastMath)
+    {
+        const int numChannels = header.numChannels;
+        const auto length     = header.sourceLength;
+
+        GateDetectorIndex::Writer writer (indexFile, header, fastMath);
+        NoiseFloorAnalyser analyser;
+        analyser.prepare (header.sampleRate);
+
+        for (juce::int64 pos = 0; writer.isOpen() && pos < header.numLevels; pos += blockSize)
+        {
+            const int numSamples = (int) juce::jmin ((juce::int64) blockSize, header.numLevels - pos);
+            const int numRead    = (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples, length - pos);
+
+            ctx.buffer.setSize (numChannels, numSamples, false, false, true);
+            ctx.buffer.clear();
+
+            if (numRead > 0)
+            {
+                reader.read (&ctx.buffer, 0, numRead, pos, true, true);
+                analyser.process (ctx.buffer.getArrayOfReadPointers(), numChannels, numRead);
+            }
+
+            if (numChannels == 1)
+                ctx.monoDetector.detect (ctx.buffer.getArrayOfReadPointers(), numSamples, ctx.scratch.get());
+            else
+                ctx.stereoDetector.detect (ctx.buffer.getArrayOfReadPointers(), numSamples, ctx.scratch.get());
+
+            writer.write (ctx.scratch.get(), numSamples);
+        }
+
+        if (analyser.hasEstimate())
+            writer.setNoiseFloor (analyser.getQuantileDb());
+
+        return writer.finish();
+    }
+
+    FileResult processFileIndexed (WorkerContext& ctx, const juce::File& input, const juce::File& output,
+                                   const juce::File& indexFile, int blockSize, double learnSeconds, bool autoThreshold)
+    {
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+        auto& processor = *ctx.processor;
+
+        // El umbral por fichero sale del índice, no del procesador. Hasta
+        // leerlo, el configurado (la clave del detector no depende del anterior)
+        FileResult result;
+
+        if (autoThreshold)
+        {
+            processor.apvts.getParameter ("AUTO_THRESHOLD")->setValueNotifyingHost (0.0f);
+            setFileThreshold (ctx, result);
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader (ctx.formatManager.createReaderFor (input));
+        auto* format = ctx.formatManager.findFormatForFileExtension (input.getFileExtension());
+
+        if (reader == nullptr || format == nullptr || ! canUseIndex (processor, (int) reader->numChannels))
+            return processFile (ctx, input, output, blockSize, learnSeconds, autoThreshold);
+
+        const int numChannels   = (int) reader->numChannels;
+        const double sampleRate = reader->sampleRate;
+        const auto length       = reader->lengthInSamples;
+        const bool fastMath     = processor.isFastMathEnabled();
+
+        // --- Detector de este fichero (latencia y clave de detección) ---
+        auto params = processor.getGateParameters();
+        int latency = 0;
+
+        ctx.scratch.realloc ((size_t) blockSize);
+
+        if (numChannels == 1)
+        {
+            ctx.monoDetector.prepare (sampleRate, blockSize);
+            ctx.monoDetector.setParameters (params);
+            latency = ctx.monoDetector.getLatencySamples();
+        }
+        else
+        {
+            ctx.stereoDetector.prepare (sampleRate, blockSize);
+            ctx.stereoDetector.setParameters (params);
+            latency = ctx.stereoDetector.getLatencySamples();
+        }
+
+        GateDetectorIndex::Header header;
+        header.numChannels    = numChannels;
+        header.latencySamples = latency;
+        header.sampleRate     = sampleRate;
+        header.sourceLength   = length;
+        header.numLevels      = length + latency;
+        header.sourceKey      = getSourceKey (input);
+        header.detectorKey    = getDetectorKey (params, sampleRate, numChannels, latency, fastMath);
+
+        // --- Índice: reutilizar o reconstruir entero ---
+        auto index = std::make_unique<GateDetectorIndex::Reader> (indexFile);
+
+        if (! index->isValid() || ! index->getHeader().matches (header))
+        {
+            index.reset();
+
+            if (! buildIndex (ctx, *reader, indexFile, header, blockSize, fastMath))
+            {
+                result.error = "no se puede escribir el índice " + indexFile.getFullPathName();
+                return result;
+            }
+
+            index = std::make_unique<GateDetectorIndex::Reader> (indexFile);
+
+            if (! index->isValid())
+            {
+                result.error = "índice no válido " + indexFile.getFullPathName();
+                return result;
+            }
+
+            result.indexUse = IndexUse::built;
+        }
+        else
+        {
+            result.indexUse = IndexUse::reused;
+        }
+
+        const auto& indexHeader = index->getHeader();
+
+        // --- Umbral por fichero a partir del suelo de ruido del índice ---
+        if (autoThreshold && indexHeader.hasNoiseFloor != 0)
+        {
+            const float marginDb = processor.apvts.getRawParameterValue ("AUTO_MARGIN")->load();
+
+            result.hasNoiseFloor = true;
+            result.noiseFloorDb  = indexHeader.noiseFloorDb;
+            result.thresholdDb   = SilentRoomAudioProcessor::noiseFloorToThresholdDb (result.noiseFloorDb, marginDb);
+
+            setFileThreshold (ctx, result);
+            params.thresholdDb = result.thresholdDb;
+        }
+
+        result.audioSeconds = (double) length / sampleRate;
+
+        // --- Salida ya al día: mismos parámetros y el fichero no se ha tocado ---
+        const auto renderKey = getRenderKey (processor, output);
+
+        if (indexHeader.renderKey == renderKey && output.existsAsFile()
+            && output.getLastModificationTime().toMilliseconds() == indexHeader.outputTime)
+        {
+            result.ok = true;
+            result.indexUse = IndexUse::unchanged;
+            result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+            return result;
+        }
+
+        auto writer = createOutputWriter (*format, *reader, output, result.error);
+
+        if (writer == nullptr)
+            return result;
+
+        // --- Render: gain computer y balística sobre el índice ---
+        // La ganancia de la muestra n es la n + L del índice: descartar las
+        // L primeras compensa la latencia igual que processFile.
+        GateDetectorIndex::Renderer renderer;
+        renderer.prepare (*index, params, fastMath);
+
+        for (int skipped = 0; skipped < latency;)
+        {
+            const int n = juce::jmin (blockSize, latency - skipped);
+            renderer.renderGains (ctx.scratch.get(), n);
+            skipped += n;
+        }
+
+        for (juce::int64 pos = 0; pos < length; pos += blockSize)
+        {
+            const int numSamples = (int) juce::jmin ((juce::int64) blockSize, length - pos);
+
+            ctx.buffer.setSize (numChannels, numSamples, false, false, true);
+            reader->read (&ctx.buffer, 0, numSamples, pos, true, true);
+            renderer.renderGains (ctx.scratch.get(), numSamples);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::multiply (ctx.buffer.getWritePointer (ch), ctx.scratch.get(), numSamples);
+
+            if (! writer->writeFromAudioSampleBuffer (ctx.buffer, 0, numSamples))
+            {
+                result.error = "error de escritura";
+                return result;
+            }
+        }
+
+        writer.reset();   // cierra y vuelca la cabecera
+
+        const auto& pathCounts = renderer.getPathCounts();
+        ctx.indexPathCounts.open   += pathCounts.open;
+        ctx.indexPathCounts.closed += pathCounts.closed;
+        ctx.indexPathCounts.full   += pathCounts.full;
+
+        // Anotar el render (el índice deja de estar proyectado antes de escribirlo)
+        index.reset();
+        GateDetectorIndex::writeRenderRecord (indexFile, renderKey, output.getLastModificationTime().toMilliseconds());
+
+        result.ok = true;
+        result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+        return result;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add (juce::CharPointer_UTF8 (argv[i]));
+
+    if (args.isEmpty() || args.contains ("--help") || args.contains ("-h"))
+    {
+        printUsage();
+        return args.isEmpty() ? 1 : 0;
+    }
+
+    BatchOptions options;
+    juce::String error;
+
+    if (! parseArguments (args, options, error))
+    {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    auto files = collectInputFiles (options);
+
+    if (files.isEmpty())
+    {
+        std::cerr << "No hay ficheros de audio que procesar\n";
+        return 1;
+    }
+
+    if (options.outputFolder != juce::File() && ! options.analyseOnly)
+        options.outputFolder.createDirectory();
+
+    // Los ficheros más largos primero: el robo de trabajo reparte mejor el final
+    std::sort (files.begin(), files.end(), [] (const juce::File& a, const juce::File& b) { return a.getSize() > b.getSize(); });
+
+    WorkStealingPool pool (juce::jmin (options.numThreads, files.size()));
+
+    // --- Contexto por worker (en el hilo de mensajes: el APVTS lo requiere) ---
+    std::vector<std::unique_ptr<WorkerContext>> contexts;
+
+    for (int w = 0; w < pool.getNumWorkers(); ++w)
+    {
+        auto ctx = std::make_unique<WorkerContext>();
+        ctx->formatManager.registerBasicFormats();
+        ctx->processor = std::make_unique<SilentRoomAudioProcessor>();
+
+        if (! applyParameters (*ctx->processor, options, error))
+        {
+            std::cerr << error << "\n";
+            return 1;
+        }
+
+        ctx->configuredThresholdDb = ctx->processor->apvts.getRawParameterValue ("THRESHOLD")->load();
+        contexts.push_back (std::move (ctx));
+    }
+
+    std::cout << "Procesando " << files.size() << " ficheros con " << pool.getNumWorkers() << " hilos\n";
+
+    std::vector<FileResult> results ((size_t) files.size());
+    std::mutex printLock;
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    pool.run (files.size(), [&] (int workerIndex, int jobIndex)
+    {
+        const auto& input = files.getReference (jobIndex);
+        auto& ctx = *contexts[(size_t) workerIndex];
+        FileResult result;
+
+        if (options.analyseOnly)
+        {
+            const auto jobStartMs = juce::Time::getMillisecondCounterHiRes();
+            analyseNoiseFloor (ctx, input, options.blockSize, result);
+            result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - jobStartMs) * 0.001;
+        }
+        else if (options.useIndex)
+        {
+            result = processFileIndexed (ctx, input, getOutputFile (input, options), getIndexFile (input, options),
+                                         options.blockSize, options.learnSeconds, options.autoThreshold);
+        }
+        else
+        {
+            result = processFile (ctx, input, getOutputFile (input, options), options.blockSize,
+                                  options.learnSeconds, options.autoThreshold);
+        }
+
+        const auto noiseFloorText = ! (options.analyseOnly || options.autoThreshold) ? juce::String()
+                                  : result.hasNoiseFloor ? juce::String::formatted ("  ruido %6.1f dB umbral %6.1f dB",
+                                                                                    result.noiseFloorDb, result.thresholdDb)
+                                                         : juce::String ("  ruido        -- (sin estimación)");
+
+        const auto indexText = result.indexUse == IndexUse::built     ? "  [índice nuevo]"
+                             : result.indexUse == IndexUse::reused    ? "  [desde índice]"
+                             : result.indexUse == IndexUse::unchanged ? "  [sin cambios]"
+                                                                      : "";
+
+        {
+            const std::lock_guard<std::mutex> sl (printLock);
+
+            if (result.ok)
+                std::cout << "  " << input.getFileName().paddedRight (' ', 48)
+                          << juce::String::formatted ("%9.2f s audio %8.3f s %8.1fx RT",
+                                                      result.audioSeconds, result.wallSeconds,
+                                                      result.audioSeconds / juce::jmax (1.0e-9, result.wallSeconds))
+                          << noiseFloorText << indexText << "\n";
+            else
+                std::cout << "  " << input.getFileName() << ": ERROR (" << result.error << ")\n";
+        }
+
+        results[(size_t) jobIndex] = std::move (result);
+    });
+
+    const auto totalWall = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+
+    // --- Resumen ---
+    double totalAudio = 0.0;
+    int numFailed = 0, numUnchanged = 0;
+
+    for (auto& r : results)
+    {
+        totalAudio += r.audioSeconds;
+        numFailed += r.ok ? 0 : 1;
+        numUnchanged += r.indexUse == IndexUse::unchanged ? 1 : 0;
+    }
+
+    std::cout << juce::String::formatted ("Total: %d ficheros (%d con error), %.2f s de audio en %.3f s -> %.1fx tiempo real\n",
+                                          files.size(), numFailed, totalAudio, totalWall,
+                                          totalAudio / juce::jmax (1.0e-9, totalWall));
+
+    if (options.useIndex)
+        std::cout << "Índice: " << numUnchanged << " ficheros sin cambios (no se han vuelto a escribir)\n";
+
+    // Tasa de acierto de las rutas rápidas de la puerta (sub-bloques, también
+    // los renderizados desde el índice)
+    double open = 0.0, closed = 0.0, full = 0.0;
+
+    for (auto& ctx : contexts)
+    {
+        open   += (double) (ctx->processor->openPathCount.load()   + ctx->indexPathCounts.open);
+        closed += (double) (ctx->processor->closedPathCount.load() + ctx->indexPathCounts.closed);
+        full   += (double) (ctx->processor->fullPathCount.load()   + ctx->indexPathCounts.full);
+    }
+
+    const auto totalPaths = juce::jmax (1.0, open + closed + full);
+
+    std::cout << juce::String::formatted ("Rutas: abierta %.1f %%, cerrada %.1f %%, completa %.1f %%\n",
+                                          100.0 * open / totalPaths, 100.0 * closed / totalPaths, 100.0 * full / totalPaths);
+
+    // Tiempo por bloque de todos los workers
+    BlockTimingStats::Snapshot timing;
+
+    for (auto& ctx : contexts)
+        timing.merge (ctx->processor->timingStats.getSnapshot());
+
+    std::cout << juce::String::formatted ("Bloques: %llu, media %.1f us, p99 %.1f us, peor %.1f us, fuera de plazo %llu\n",
+                                          (unsigned long long) timing.numBlocks, timing.meanMicros,
+                                          timing.getPercentileMicros (0.99), timing.worstMicros,
+                                          (unsigned long long) timing.deadlineMisses);
+
+    if (RealtimeGuard::getNumViolations() > 0)
+        std::cout << "Aviso: " << (juce::int64) RealtimeGuard::getNumViolations()
+                  << " reservas o locks en processBlock\n";
+
+    if (options.statsFile != juce::File())
+    {
+        auto json = timing.toVar();
+        json.getDynamicObject()->setProperty ("realtimeViolations", (juce::int64) RealtimeGuard::getNumViolations());
+
+        if (! options.statsFile.replaceWithText (juce::JSON::toString (json)))
+            std::cerr << "No se puede escribir " << options.statsFile.getFullPathName() << "\n";
+    }
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.h
+
+    Pool de hilos con robo de trabajo para el procesado por lotes.
+    Cada worker tiene su propia cola: consume por el principio de la suya
+    (en el orden del reparto, los trabajos más costosos primero) y, cuando
+    se vacía, roba por el final de la de otro worker (los más baratos que
+    le queden), de modo que los trabajos largos no se acumulan al final.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class WorkStealingPool
+{
+public:
+    // job (workerIndex, jobIndex): workerIndex permite usar contexto por hilo
+    using Job = std::function<void (int workerIndex, int jobIndex)>;
+
+    explicit WorkStealingPool (int numWorkersToUse)
+        : queues ((size_t) juce::jmax (1, numWorkersToUse))
+    {
+    }
+
+    int getNumWorkers() const noexcept     { return (int) queues.size(); }
+
+    // Reparte los trabajos 0..numJobs-1 en round-robin y bloquea hasta terminar.
+    // Conviene ordenar los trabajos de mayor a menor coste antes de llamar.
+    void run (int numJobs, const Job& job)
+    {
+        for (int i = 0; i < numJobs; ++i)
+            queues[(size_t) (i % getNumWorkers())].jobs.push_back (i);
+
+        std::vector<std::thread> threads;
+        threads.reserve (queues.size());
+
+        for (int w = 0; w < getNumWorkers(); ++w)
+            threads.emplace_back ([this, w, &job] { workerLoop (w, job); });
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<int> jobs;
+    };
+
+    void workerLoop (int workerIndex, const Job& job)
+    {
+        int jobIndex = 0;
+
+        while (popOwn (workerIndex, jobIndex) || steal (workerIndex, jobIndex))
+            job (workerIndex, jobIndex);
+    }
+
+    bool popOwn (int workerIndex, int& jobIndex)
+    {
+        auto& q = queues[(size_t) workerIndex];
+        const std::lock_guard<std::mutex> sl (q.lock);
+
+        if (q.jobs.empty())
+            return false;
+
+        jobIndex = q.jobs.front();
+        q.jobs.pop_front();
+        return true;
+    }
+
+    bool steal (int thiefIndex, int& jobIndex)
+    {
+        // Recorre las demás colas empezando por la siguiente a la propia
+        for (int offset = 1; offset < getNumWorkers(); ++offset)
+        {
+            auto& victim = queues[(size_t) ((thiefIndex + offset) % getNumWorkers())];
+            const std::lock_guard<std::mutex> sl (victim.lock);
+
+            if (! victim.jobs.empty())
+            {
+                jobIndex = victim.jobs.back();
+                victim.jobs.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::vector<Queue> queues;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkStealingPool)
+};
@@ -0,0 +1,999 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    SilentRoomBench: microbenchmark del núcleo DSP de la puerta (GateEngine)
+    sin host ni AudioProcessor. Recorre tamaños de bloque, mono/estéreo,
+    precisión (float con FastMath, float exacto, double nativo y double
+    convertido a float por el host) y tipo de señal, y mide el coste por
+    muestra con varias repeticiones. Además mide
+    MultichannelGateEngine en 5.1, 7.1.4 y ambisónico de orden 3 con cada
+    modo de enlace (el coste es por muestra y canal, comparable con estéreo),
+    el coste del filtro de key frente al detector sin filtro, el de los
+    detectores RMS y true peak frente a peak, el de hold e histéresis, el
+    de la rodilla suave y el rango, la ruta abierta con ratio 1:1 en
+    silencio digital, el del modo multibanda
+    (2 a 4 bandas: divisor, una puerta por banda y suma) y el del modo
+    espectral (STFT a 96 kHz en estéreo, en % de un núcleo). Por último,
+    crea y prepara N instancias de SilentRoomAudioProcessor y mide el
+    tiempo de construcción y de prepareToPlay, la memoria del proceso (RSS)
+    y la que comparten a través de SharedResourcePool.
+
+    Salida: tabla legible por stdout y, con --json, un fichero JSON con todos
+    los casos para seguir regresiones entre optimizaciones de processBlock.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <functional>
+#include <iostream>
+#include "../../../Source/GateEngine.h"
+#include "../../../Source/MultichannelGateEngine.h"
+#include "../../../Source/MultibandGateEngine.h"
+#include "../../../Source/SpectralGateEngine.h"
+#include "../../../Source/PluginProcessor.h"
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    //==============================================================================
+    struct BenchOptions
+    {
+        juce::Array<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        double sampleRate   = 48000.0;
+        double audioSeconds = 2.0;   // audio procesado en cada repetición
+        int repeats         = 7;
+        GateParameters params;
+        juce::File jsonFile;
+        int numInstances = 100;      // sección de instancias múltiples
+    };
+
+    enum class Signal { silence, quietNoise, speechBursts, fullScaleSine };
+
+    const char* getSignalName (Signal s)
+    {
+        switch (s)
+        {
+            case Signal::silence:        return "silence";
+            case Signal::quietNoise:     return "noise-below-threshold";
+            case Signal::speechBursts:   return "speech-bursts";
+            case Signal::fullScaleSine:  return "sine-0dBFS";
+        }
+
+        return "";
+    }
+
+    enum class Precision { floatFast, floatExact, doublePrecision, doubleViaFloat };
+
+    const char* getLinkModeName (GateLinkMode m)
+    {
+        switch (m)
+        {
+            case GateLinkMode::linked:    return "linked";
+            case GateLinkMode::unlinked:  return "unlinked";
+            case GateLinkMode::grouped:   return "grouped";
+        }
+
+        return "";
+    }
+
+    const char* getKeyFilterName (KeyFilterMode m)
+    {
+        switch (m)
+        {
+            case KeyFilterMode::off:       return "off";
+            case KeyFilterMode::highPass:  return "highpass";
+            case KeyFilterMode::lowPass:   return "lowpass";
+            case KeyFilterMode::bandPass:  return "bandpass";
+        }
+
+        return "";
+    }
+
+    const char* getDetectorName (DetectorMode m)
+    {
+        switch (m)
+        {
+            case DetectorMode::peak:      return "peak";
+            case DetectorMode::rms:       return "rms";
+            case DetectorMode::truePeak:  return "truepeak";
+        }
+
+        return "";
+    }
+
+    const char* getPrecisionName (Precision p)
+    {
+        switch (p)
+        {
+            case Precision::floatFast:        return "float-fast";
+            case Precision::floatExact:       return "float-exact";
+            case Precision::doublePrecision:  return "double";
+            case Precision::doubleViaFloat:   return "double-via-float";
+        }
+
+        return "";
+    }
+
+    struct CaseResult
+    {
+        Precision precision;
+        Signal signal;
+        int numChannels = 0, blockSize = 0;
+
+        double nsPerSample = 0.0;         // mediana, por muestra y canal
+        double nsPerSampleMin = 0.0;
+        double nsPerSampleStdDev = 0.0;
+        double realtimeFactor = 0.0;      // canales x tiempo real (con la mediana)
+        GatePathCounts paths;
+
+        GateParameters params;            // los de la medida (filtro de key, detector, hold...)
+        juce::String layout;              // mono, stereo, 5.1, 7.1.4, ambi3...
+        GateLinkMode linkMode = GateLinkMode::linked;
+        int numGroups = 1;                // detectores independientes
+        int numBands = 1;                 // 1 = banda ancha
+        bool spectral = false;            // modo espectral (STFT)
+    };
+
+    //==============================================================================
+    void printUsage()
+    {
+        std::cout << "SilentRoomBench - microbenchmark de GateEngine\n\n"
+                     "Uso: SilentRoomBench [opciones]\n\n"
+                     "  --blocks <lista>      tamaños de bloque separados por comas (por defecto 16..4096)\n"
+                     "  --seconds <s>         audio por repetición (por defecto 2)\n"
+                     "  --repeats <n>         repeticiones por caso (por defecto 7)\n"
+                     "  --rate <Hz>           frecuencia de muestreo (por defecto 48000)\n"
+                     "  --threshold <dB>      --ratio <N>  --attack <ms>  --release <ms>  --lookahead <ms>\n"
+                     "  --instances <n>       instancias de SilentRoomAudioProcessor a preparar (por defecto 100)\n"
+                     "  --json <fichero>      guardar los resultados en JSON\n";
+    }
+
+    bool parseArguments (const juce::StringArray& args, BenchOptions& options, juce::String& error)
+    {
+        // Parámetros de la puerta para el benchmark: umbral a -40 dB y ratio alto,
+        // de forma que cada señal cae en una ruta distinta
+        options.params.thresholdDb = -40.0f;
+        options.params.ratio       = 10.0f;
+        options.params.attackMs    = 5.0f;
+        options.params.releaseMs   = 100.0f;
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto arg  = args[i];
+            const auto name = arg.substring (2).upToFirstOccurrenceOf ("=", false, false);
+            juce::String value;
+
+            if (! arg.startsWith ("--"))
+            {
+                error = "Argumento inesperado: " + arg;
+                return false;
+            }
+
+            if (arg.containsChar ('='))
+                value = arg.fromFirstOccurrenceOf ("=", false, false);
+            else if (i + 1 < args.size())
+                value = args[++i];
+            else
+            {
+                error = "Falta el valor de --" + name;
+                return false;
+            }
+
+            if (name == "blocks")
+            {
+                options.blockSizes.clear();
+
+                for (auto& token : juce::StringArray::fromTokens (value, ",", {}))
+                    options.blockSizes.add (juce::jlimit (1, 1 << 16, token.getIntValue()));
+            }
+            else if (name == "seconds")    options.audioSeconds = juce::jmax (0.01, value.getDoubleValue());
+            else if (name == "repeats")    options.repeats = juce::jmax (1, value.getIntValue());
+            else if (name == "rate")       options.sampleRate = juce::jlimit (8000.0, 768000.0, value.getDoubleValue());
+            else if (name == "threshold")  options.params.thresholdDb = value.getFloatValue();
+            else if (name == "ratio")      options.params.ratio = juce::jmax (1.0f, value.getFloatValue());
+            else if (name == "attack")     options.params.attackMs = juce::jmax (0.1f, value.getFloatValue());
+            else if (name == "release")    options.params.releaseMs = juce::jmax (0.1f, value.getFloatValue());
+            else if (name == "lookahead")  options.params.lookaheadMs = value.getFloatValue();
+            else if (name == "instances")  options.numInstances = juce::jlimit (1, 10000, value.getIntValue());
+            else if (name == "json")       options.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile (value);
+            else
+            {
+                error = "Opción desconocida: " + arg;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // Señales de prueba deterministas (misma semilla en cada ejecución)
+    template <typename SampleType>
+    void fillSignal (juce::AudioBuffer<SampleType>& buffer, Signal signal, double sampleRate)
+    {
+        juce::Random random (0x5117e47);
+        const int numSamples = buffer.getNumSamples();
+
+        buffer.clear();
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer (ch);
+
+            switch (signal)
+            {
+                case Signal::silence:
+                    break;
+
+                case Signal::quietNoise:
+                    // Ruido blanco con pico a -50 dBFS: siempre bajo el umbral
+                    for (int i = 0; i < numSamples; ++i)
+                        data[i] = (SampleType) ((random.nextFloat() * 2.0f - 1.0f) * 0.00316f);
+                    break;
+
+                case Signal::speechBursts:
+                {
+                    // Ráfagas tipo sílaba: 120-300 ms de ruido con envolvente
+                    // senoidal y nivel aleatorio, separadas por pausas a -70 dBFS
+                    int pos = 0;
+
+                    while (pos < numSamples)
+                    {
+                        const int burst = (int) (sampleRate * (0.12 + 0.18 * random.nextDouble()));
+                        const int pause = (int) (sampleRate * (0.05 + 0.25 * random.nextDouble()));
+                        const float level = juce::Decibels::decibelsToGain (-30.0f + 24.0f * random.nextFloat());
+
+                        for (int i = 0; i < burst && pos < numSamples; ++i, ++pos)
+                        {
+                            const auto shape = std::sin (juce::MathConstants<double>::pi * i / burst);
+                            data[pos] = (SampleType) ((random.nextFloat() * 2.0f - 1.0f) * level * shape);
+                        }
+
+                        for (int i = 0; i < pause && pos < numSamples; ++i, ++pos)
+                            data[pos] = (SampleType) ((random.nextFloat() * 2.0f - 1.0f) * 0.000316f);
+                    }
+                    break;
+                }
+
+                case Signal::fullScaleSine:
+                    for (int i = 0; i < numSamples; ++i)
+                        data[i] = (SampleType) std::sin (juce::MathConstants<double>::twoPi * 1000.0 * i / sampleRate);
+                    break;
+            }
+        }
+    }
+
+    //==============================================================================
+    // Mide un motor ya preparado: una repetición de calentamiento y N medidas
+    template <typename SampleType, typename Engine>
+    CaseResult timeEngine (Engine& engine, const BenchOptions& options, Signal signal, int numChannels, int blockSize)
+    {
+        const int totalSamples = juce::roundToInt (options.audioSeconds * options.sampleRate);
+
+        juce::AudioBuffer<SampleType> source (numChannels, totalSamples), work (numChannels, totalSamples);
+        fillSignal (source, signal, options.sampleRate);
+
+        CaseResult result;
+        result.signal      = signal;
+        result.params      = options.params;
+        result.numChannels = numChannels;
+        result.blockSize   = blockSize;
+
+        juce::HeapBlock<SampleType*> channels ((size_t) numChannels);
+        juce::Array<double> nsPerSample;
+
+        // Repetición 0: calentamiento (cachés, predictor de saltos), no se cuenta
+        for (int run = 0; run <= options.repeats; ++run)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                work.copyFrom (ch, 0, source, ch, 0, totalSamples);
+
+            engine.reset();
+            GatePathCounts paths;
+
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int pos = 0; pos < totalSamples; pos += blockSize)
+            {
+                const int numSamples = juce::jmin (blockSize, totalSamples - pos);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    channels[ch] = work.getWritePointer (ch) + pos;
+
+                // Igual que processBlock: parámetros en cada bloque
+                engine.setParameters (options.params);
+                engine.process (channels, numSamples);
+
+                const auto& counts = engine.getLastPathCounts();
+                paths.open   += counts.open;
+                paths.closed += counts.closed;
+                paths.full   += counts.full;
+            }
+
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+            if (run > 0)
+            {
+                nsPerSample.add (elapsed * 1.0e9 / ((double) totalSamples * numChannels));
+                result.paths = paths;
+            }
+        }
+
+        // Mediana, mínimo y desviación típica de las repeticiones
+        std::sort (nsPerSample.begin(), nsPerSample.end());
+
+        double mean = 0.0;
+        for (auto v : nsPerSample)
+            mean += v;
+        mean /= nsPerSample.size();
+
+        double variance = 0.0;
+        for (auto v : nsPerSample)
+            variance += (v - mean) * (v - mean);
+        variance /= juce::jmax (1, nsPerSample.size() - 1);
+
+        result.nsPerSample       = nsPerSample[nsPerSample.size() / 2];
+        result.nsPerSampleMin    = nsPerSample.getFirst();
+        result.nsPerSampleStdDev = std::sqrt (variance);
+        result.realtimeFactor    = 1.0e9 / (options.sampleRate * juce::jmax (1.0e-6, result.nsPerSample));
+        return result;
+    }
+
+    template <typename SampleType, int NumChannels>
+    CaseResult runCase (const BenchOptions& options, Precision precision, Signal signal, int blockSize)
+    {
+        GateEngine<SampleType, NumChannels> engine;
+        engine.prepare (options.sampleRate, blockSize);
+        engine.setFastMathEnabled (precision == Precision::floatFast);
+
+        auto result = timeEngine<SampleType> (engine, options, signal, NumChannels, blockSize);
+        result.precision = precision;
+        result.layout    = NumChannels == 1 ? "mono" : "stereo";
+        return result;
+    }
+
+    template <typename SampleType>
+    CaseResult runCase (const BenchOptions& options, Precision precision, Signal signal, int numChannels, int blockSize)
+    {
+        return numChannels == 1 ? runCase<SampleType, 1> (options, precision, signal, blockSize)
+                                : runCase<SampleType, 2> (options, precision, signal, blockSize);
+    }
+
+    // Lo que hace un host que entrega double a un plugin sin soporte de
+    // double: convierte el bloque a float, procesa con el motor float (exacto,
+    // como el procesador por defecto) y devuelve el resultado en double
+    template <int NumChannels>
+    class ConvertingEngine
+    {
+    public:
+        void prepare (double sampleRate, int blockSize)
+        {
+            engine.prepare (sampleRate, blockSize);
+            scratch.setSize (NumChannels, blockSize);
+        }
+
+        void reset() noexcept                                     { engine.reset(); }
+        void setParameters (const GateParameters& params) noexcept { engine.setParameters (params); }
+        const GatePathCounts& getLastPathCounts() const noexcept  { return engine.getLastPathCounts(); }
+
+        void process (double* const* channels, int numSamples) noexcept
+        {
+            float* floatChannels[NumChannels];
+
+            for (int ch = 0; ch < NumChannels; ++ch)
+            {
+                floatChannels[ch] = scratch.getWritePointer (ch);
+
+                for (int i = 0; i < numSamples; ++i)
+                    floatChannels[ch][i] = (float) channels[ch][i];
+            }
+
+            engine.process (floatChannels, numSamples);
+
+            for (int ch = 0; ch < NumChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    channels[ch][i] = (double) floatChannels[ch][i];
+        }
+
+    private:
+        GateEngine<float, NumChannels> engine;
+        juce::AudioBuffer<float> scratch;
+    };
+
+    template <int NumChannels>
+    CaseResult runConvertingCase (const BenchOptions& options, Signal signal, int blockSize)
+    {
+        ConvertingEngine<NumChannels> engine;
+        engine.prepare (options.sampleRate, blockSize);
+
+        auto result = timeEngine<double> (engine, options, signal, NumChannels, blockSize);
+        result.precision = Precision::doubleViaFloat;
+        result.layout    = NumChannels == 1 ? "mono" : "stereo";
+        return result;
+    }
+
+    CaseResult runConvertingCase (const BenchOptions& options, Signal signal, int numChannels, int blockSize)
+    {
+        return numChannels == 1 ? runConvertingCase<1> (options, signal, blockSize)
+                                : runConvertingCase<2> (options, signal, blockSize);
+    }
+
+    // Bus multicanal completo en una sola instancia (float con FastMath)
+    CaseResult runMultichannelCase (const BenchOptions& options, const juce::AudioChannelSet& layout,
+                                    const juce::String& layoutName, GateLinkMode linkMode, Signal signal, int blockSize)
+    {
+        MultichannelGateEngine<float> engine;
+        engine.prepare (options.sampleRate, blockSize, layout);
+        engine.setFastMathEnabled (true);
+        engine.setLinkMode (linkMode);
+
+        auto result = timeEngine<float> (engine, options, signal, layout.size(), blockSize);
+        result.precision = Precision::floatFast;
+        result.layout    = layoutName;
+        result.linkMode  = linkMode;
+        result.numGroups = engine.getNumGroups();
+        return result;
+    }
+
+    // Modo multibanda en estéreo (float con FastMath): umbral y ratio de
+    // options en todas las bandas, cortes por defecto
+    CaseResult runMultibandCase (const BenchOptions& options, int numBands, Signal signal, int blockSize)
+    {
+        MultibandParameters bandParams;
+        bandParams.numBands = numBands;
+
+        for (int b = 0; b < MultibandGateEngine<float>::maxBands; ++b)
+        {
+            bandParams.thresholdDb[b] = options.params.thresholdDb;
+            bandParams.ratio[b]       = options.params.ratio;
+        }
+
+        MultibandGateEngine<float> engine;
+        engine.prepare (options.sampleRate, blockSize, juce::AudioChannelSet::stereo());
+        engine.setFastMathEnabled (true);
+        engine.setMultibandParameters (bandParams);
+
+        auto result = timeEngine<float> (engine, options, signal, 2, blockSize);
+        result.precision = Precision::floatFast;
+        result.layout    = "stereo";
+        result.numBands  = numBands;
+        return result;
+    }
+
+    // Modo espectral en estéreo (float con FastMath). Antes de medir se
+    // aprende un perfil de ruido a -50 dBFS para que la medida recorra la
+    // ruta con puerta por bin (FFT directa e inversa en cada trama).
+    CaseResult runSpectralCase (const BenchOptions& options, Signal signal, int blockSize)
+    {
+        SpectralGateEngine<float> engine;
+        engine.prepare (options.sampleRate, blockSize, juce::AudioChannelSet::stereo());
+        engine.setFastMathEnabled (true);
+
+        {
+            juce::AudioBuffer<float> noise (2, juce::roundToInt (options.sampleRate));
+            fillSignal (noise, Signal::quietNoise, options.sampleRate);
+
+            SpectralParameters learning;
+            learning.learning = true;
+            engine.setSpectralParameters (learning);
+            engine.setParameters (options.params);
+            engine.process (noise.getArrayOfWritePointers(), noise.getNumSamples());
+            engine.setSpectralParameters (SpectralParameters());
+        }
+
+        auto result = timeEngine<float> (engine, options, signal, 2, blockSize);
+        result.precision = Precision::floatFast;
+        result.layout    = "stereo";
+        result.spectral  = true;
+        return result;
+    }
+
+    //==============================================================================
+    // Memoria residente del proceso en bytes (Linux: /proc/self/statm); 0 si no
+    // se puede leer
+    juce::int64 getResidentBytes()
+    {
+       #if JUCE_LINUX
+        const auto fields = juce::StringArray::fromTokens (juce::File ("/proc/self/statm").loadFileAsString(), " ", {});
+
+        if (fields.size() > 1)
+            return fields[1].getLargeIntValue() * (juce::int64) sysconf (_SC_PAGESIZE);
+       #endif
+
+        return 0;
+    }
+
+    struct InstanceResult
+    {
+        int numInstances = 0;
+        double constructMs    = 0.0;      // N constructores (APVTS y motores, sin prepare)
+        double firstPrepareMs = 0.0;      // construye los recursos compartidos
+        double meanPrepareMs  = 0.0;      // resto de instancias (los reutilizan)
+        juce::int64 residentBytes = 0;    // RSS añadido con todas preparadas (0 = no disponible)
+        SharedResourcePool::Stats pool;
+    };
+
+    // Crea numInstances SilentRoomAudioProcessor con el bus estéreo por defecto
+    // y los prepara a options.sampleRate con bloques de 512, como un host al
+    // abrir una plantilla grande. Las estadísticas del pool y la memoria se
+    // leen con todas vivas.
+    InstanceResult runInstanceCase (const BenchOptions& options)
+    {
+        constexpr int blockSize = 512;
+
+        InstanceResult result;
+        result.numInstances = options.numInstances;
+
+        const auto residentBefore = getResidentBytes();
+
+        std::vector<std::unique_ptr<SilentRoomAudioProcessor>> instances;
+        auto start = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < options.numInstances; ++i)
+            instances.push_back (std::make_unique<SilentRoomAudioProcessor>());
+
+        result.constructMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+        double restMs = 0.0;
+
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            start = juce::Time::getMillisecondCounterHiRes();
+
+            instances[i]->setRateAndBufferSizeDetails (options.sampleRate, blockSize);
+            instances[i]->prepareToPlay (options.sampleRate, blockSize);
+
+            const auto elapsedMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+            if (i == 0)
+                result.firstPrepareMs = elapsedMs;
+            else
+                restMs += elapsedMs;
+        }
+
+        result.meanPrepareMs = options.numInstances > 1 ? restMs / (options.numInstances - 1) : result.firstPrepareMs;
+
+        if (residentBefore > 0)
+            result.residentBytes = getResidentBytes() - residentBefore;
+
+        result.pool = juce::SharedResourcePointer<SharedResourcePool>()->getStats();
+        return result;
+    }
+
+    //==============================================================================
+    // Porcentaje de sub-bloques de una ruta sobre el total del caso
+    double getPathPercent (const CaseResult& r, juce::uint64 count)
+    {
+        return 100.0 * (double) count / (double) juce::jmax ((juce::uint64) 1, r.paths.open + r.paths.closed + r.paths.full);
+    }
+
+    // Una fila de una sección: etiqueta y cómo medirla con un tamaño de bloque
+    struct SectionRow
+    {
+        juce::String label;
+        std::function<CaseResult (int blockSize)> run;
+        bool keepResult = true;   // false: ya se guarda desde otra sección
+    };
+
+    // Columna opcional al final de cada línea (reparto por rutas, grupos...)
+    using ExtraColumn = std::function<juce::String (const CaseResult&)>;
+
+    // Mide cada fila con todos los tamaños de bloque e imprime una línea por
+    // medida con las columnas comunes de coste
+    void runSection (const BenchOptions& options, const char* title, const juce::String& labelHeader,
+                     const std::vector<SectionRow>& rows, std::vector<CaseResult>& results,
+                     const char* extraHeader = "", const ExtraColumn& extraColumn = nullptr)
+    {
+        int labelWidth = labelHeader.length() + 1;
+
+        for (auto& row : rows)
+            labelWidth = juce::jmax (labelWidth, row.label.length() + 1);
+
+        std::cout << "\n";
+
+        if (title != nullptr)
+            std::cout << title << "\n";
+
+        std::cout << labelHeader.paddedRight (' ', labelWidth)
+                  << "can  bloque    ns/muestra   (min,  desv)    x RT" << extraHeader << "\n";
+
+        for (auto& row : rows)
+        {
+            for (auto blockSize : options.blockSizes)
+            {
+                const auto r = row.run (blockSize);
+
+                std::cout << row.label.paddedRight (' ', labelWidth)
+                          << juce::String::formatted ("%3d %7d %12.3f  (%6.3f %6.3f) %8.0f",
+                                                      r.numChannels, blockSize, r.nsPerSample,
+                                                      r.nsPerSampleMin, r.nsPerSampleStdDev, r.realtimeFactor)
+                          << (extraColumn != nullptr ? extraColumn (r) : juce::String()) << "\n";
+
+                if (row.keepResult)
+                    results.push_back (r);
+            }
+        }
+    }
+
+    // Filas mono y estéreo (float-fast, speech-bursts) con los parámetros de
+    // options retocados por configure: las secciones por función de la puerta
+    void addGateRows (std::vector<SectionRow>& rows, const BenchOptions& options, const juce::String& label,
+                      const std::function<void (GateParameters&)>& configure)
+    {
+        auto caseOptions = options;
+        configure (caseOptions.params);
+
+        for (int numChannels = 1; numChannels <= 2; ++numChannels)
+            rows.push_back ({ label, [caseOptions, numChannels] (int blockSize)
+                              { return runCase<float> (caseOptions, Precision::floatFast, Signal::speechBursts, numChannels, blockSize); } });
+    }
+
+    //==============================================================================
+    juce::var toVar (const CaseResult& r)
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty ("precision",         getPrecisionName (r.precision));
+        obj->setProperty ("signal",            getSignalName (r.signal));
+        obj->setProperty ("layout",            r.layout);
+        obj->setProperty ("link",              getLinkModeName (r.linkMode));
+        obj->setProperty ("groups",            r.numGroups);
+        obj->setProperty ("keyFilter",         getKeyFilterName (r.params.keyFilter));
+        obj->setProperty ("detector",          getDetectorName (r.params.detector));
+        obj->setProperty ("holdMs",            r.params.holdMs);
+        obj->setProperty ("hysteresisDb",      r.params.hysteresisDb);
+        obj->setProperty ("kneeDb",            r.params.kneeDb);
+        obj->setProperty ("rangeDb",           r.params.rangeDb);
+        obj->setProperty ("bands",             r.numBands);
+        obj->setProperty ("spectral",          r.spectral);
+        obj->setProperty ("channels",          r.numChannels);
+        obj->setProperty ("blockSize",         r.blockSize);
+        obj->setProperty ("nsPerSample",       r.nsPerSample);
+        obj->setProperty ("nsPerSampleMin",    r.nsPerSampleMin);
+        obj->setProperty ("nsPerSampleStdDev", r.nsPerSampleStdDev);
+        obj->setProperty ("channelsRealtime",  r.realtimeFactor);
+        obj->setProperty ("openPathPct",       getPathPercent (r, r.paths.open));
+        obj->setProperty ("closedPathPct",     getPathPercent (r, r.paths.closed));
+        obj->setProperty ("fullPathPct",       getPathPercent (r, r.paths.full));
+        return juce::var (obj);
+    }
+
+    // Mismo caso salvo la precisión: señal, formato, parámetros y bloque
+    bool isSameCase (const CaseResult& a, const CaseResult& b)
+    {
+        const auto& p = a.params;
+        const auto& q = b.params;
+
+        return a.signal == b.signal && a.layout == b.layout && a.linkMode == b.linkMode
+            && a.numBands == b.numBands && a.spectral == b.spectral
+            && a.numChannels == b.numChannels && a.blockSize == b.blockSize
+            && p.thresholdDb == q.thresholdDb && p.ratio == q.ratio
+            && p.keyFilter == q.keyFilter && p.keyFrequencyHz == q.keyFrequencyHz
+            && p.detector == q.detector && p.rmsWindowMs == q.rmsWindowMs
+            && p.holdMs == q.holdMs && p.hysteresisDb == q.hysteresisDb
+            && p.kneeDb == q.kneeDb && p.rangeDb == q.rangeDb;
+    }
+
+    // Media geométrica del cociente de coste entre dos precisiones (mismo caso)
+    double geometricMeanRatio (const std::vector<CaseResult>& results, Precision numerator, Precision denominator)
+    {
+        double logSum = 0.0;
+        int count = 0;
+
+        for (auto& a : results)
+        {
+            if (a.precision != numerator)
+                continue;
+
+            for (auto& b : results)
+            {
+                if (b.precision == denominator && isSameCase (a, b))
+                {
+                    logSum += std::log (a.nsPerSample / juce::jmax (1.0e-9, b.nsPerSample));
+                    ++count;
+                }
+            }
+        }
+
+        return count > 0 ? std::exp (logSum / count) : 0.0;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // Las instancias de SilentRoomAudioProcessor (APVTS) necesitan el hilo de mensajes
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add (juce::CharPointer_UTF8 (argv[i]));
+
+    if (args.contains ("--help") || args.contains ("-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    BenchOptions options;
+    juce::String error;
+
+    if (! parseArguments (args, options, error))
+    {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    const Signal signals[]       = { Signal::silence, Signal::quietNoise, Signal::speechBursts, Signal::fullScaleSine };
+    const Precision precisions[] = { Precision::floatFast, Precision::floatExact, Precision::doublePrecision, Precision::doubleViaFloat };
+
+    std::vector<CaseResult> results;
+
+    std::cout << "SilentRoomBench: " << juce::SystemStats::getCpuModel() << "\n"
+              << juce::String::formatted ("%.0f Hz, %.2f s por repetición, %d repeticiones, threshold %.1f dB, ratio %.1f:1\n",
+                                          options.sampleRate, options.audioSeconds, options.repeats,
+                                          options.params.thresholdDb, options.params.ratio);
+
+    // --- Tabla principal: precisión x señal x canales, con el reparto por rutas ---
+    {
+        std::vector<SectionRow> rows;
+
+        for (auto precision : precisions)
+        {
+            for (auto signal : signals)
+            {
+                const auto label = juce::String (getPrecisionName (precision)).paddedRight (' ', 17) + getSignalName (signal);
+
+                for (int numChannels = 1; numChannels <= 2; ++numChannels)
+                {
+                    rows.push_back ({ label, [&options, precision, signal, numChannels] (int blockSize)
+                    {
+                        return precision == Precision::doublePrecision ? runCase<double> (options, precision, signal, numChannels, blockSize)
+                             : precision == Precision::doubleViaFloat  ? runConvertingCase (options, signal, numChannels, blockSize)
+                                                                       : runCase<float>  (options, precision, signal, numChannels, blockSize);
+                    } });
+                }
+            }
+        }
+
+        const auto header = juce::String::fromUTF8 ("precisión").paddedRight (' ', 17) + juce::String::fromUTF8 ("señal");
+
+        runSection (options, nullptr, header, rows, results, "  abierta cerrada completa", [] (const CaseResult& r)
+                    {
+                        return juce::String::formatted ("  %6.1f%% %6.1f%% %6.1f%%", getPathPercent (r, r.paths.open),
+                                                        getPathPercent (r, r.paths.closed), getPathPercent (r, r.paths.full));
+                    });
+    }
+
+    // --- Buses multicanal: una instancia para todo el bus, por modo de enlace ---
+    {
+        struct MultichannelLayout { juce::AudioChannelSet set; const char* name; };
+
+        const MultichannelLayout layouts[] = { { juce::AudioChannelSet::create5point1(),       "5.1" },
+                                               { juce::AudioChannelSet::create7point1point4(), "7.1.4" },
+                                               { juce::AudioChannelSet::ambisonic (3),         "ambi3" } };
+
+        const GateLinkMode linkModes[] = { GateLinkMode::linked, GateLinkMode::unlinked, GateLinkMode::grouped };
+
+        std::vector<SectionRow> rows;
+
+        for (auto& layout : layouts)
+            for (auto linkMode : linkModes)
+                rows.push_back ({ juce::String (layout.name).paddedRight (' ', 9) + getLinkModeName (linkMode),
+                                  [&options, layout, linkMode] (int blockSize)
+                                  { return runMultichannelCase (options, layout.set, layout.name, linkMode, Signal::speechBursts, blockSize); } });
+
+        runSection (options, "Multicanal (float-fast, speech-bursts)", "formato  enlace", rows, results,
+                    " grupos", [] (const CaseResult& r) { return juce::String::formatted (" %6d", r.numGroups); });
+    }
+
+    // --- Filtro de key: coste del detector con y sin filtro (off = ruta de siempre) ---
+    {
+        std::vector<SectionRow> rows;
+
+        for (auto keyFilter : { KeyFilterMode::off, KeyFilterMode::highPass, KeyFilterMode::bandPass })
+            addGateRows (rows, options, getKeyFilterName (keyFilter), [keyFilter] (GateParameters& p)
+            {
+                p.keyFilter      = keyFilter;
+                p.keyFrequencyHz = 1000.0f;
+            });
+
+        runSection (options, "Filtro de key (float-fast, speech-bursts, 1 kHz)", "filtro", rows, results);
+    }
+
+    // --- Modos del detector: coste de RMS y true peak frente a peak ---
+    {
+        std::vector<SectionRow> rows;
+
+        for (auto detector : { DetectorMode::peak, DetectorMode::rms, DetectorMode::truePeak })
+            addGateRows (rows, options, getDetectorName (detector), [detector] (GateParameters& p)
+            {
+                p.detector    = detector;
+                p.rmsWindowMs = 10.0f;
+            });
+
+        runSection (options, "Detector (float-fast, speech-bursts, RMS 10 ms)", "detector", rows, results);
+    }
+
+    // --- Hold e histéresis: máquina de estados fundida con la balística ---
+    {
+        struct HoldSetting { float holdMs, hysteresisDb; };
+        std::vector<SectionRow> rows;
+
+        for (auto setting : { HoldSetting { 0.0f, 0.0f }, HoldSetting { 50.0f, 6.0f } })
+            addGateRows (rows, options, juce::String (setting.holdMs, 0) + "/" + juce::String (setting.hysteresisDb, 0),
+                         [setting] (GateParameters& p)
+                         {
+                             p.holdMs       = setting.holdMs;
+                             p.hysteresisDb = setting.hysteresisDb;
+                         });
+
+        runSection (options, "Hold e histéresis (float-fast, speech-bursts)", "hold/hist", rows, results,
+                    "   abierta", [] (const CaseResult& r) { return juce::String::formatted (" %7.1f%%", getPathPercent (r, r.paths.open)); });
+    }
+
+    // --- Rodilla y rango: coste de la curva suave y aciertos de la ruta cerrada ---
+    {
+        struct CurveSetting { float kneeDb, rangeDb; };
+        std::vector<SectionRow> rows;
+
+        for (auto setting : { CurveSetting { 0.0f, 100.0f }, CurveSetting { 6.0f, 100.0f }, CurveSetting { 6.0f, 40.0f } })
+            addGateRows (rows, options, juce::String (setting.kneeDb, 0) + "/" + juce::String (setting.rangeDb, 0),
+                         [setting] (GateParameters& p)
+                         {
+                             p.kneeDb  = setting.kneeDb;
+                             p.rangeDb = setting.rangeDb;
+                         });
+
+        runSection (options, "Rodilla y rango (float-fast, speech-bursts)", "knee/rng", rows, results,
+                    "   cerrada", [] (const CaseResult& r) { return juce::String::formatted (" %7.1f%%", getPathPercent (r, r.paths.closed)); });
+    }
+
+    // --- Ratio 1:1: la puerta no actúa y todo debe ir por la ruta abierta,
+    //     también con silencio digital (ceros exactos en el detector) ---
+    {
+        auto unityOptions = options;
+        unityOptions.params.ratio = 1.0f;
+
+        std::vector<SectionRow> rows;
+
+        for (auto signal : { Signal::silence, Signal::speechBursts })
+            for (int numChannels = 1; numChannels <= 2; ++numChannels)
+                rows.push_back ({ getSignalName (signal), [unityOptions, signal, numChannels] (int blockSize)
+                                  { return runCase<float> (unityOptions, Precision::floatFast, signal, numChannels, blockSize); } });
+
+        const auto numResults = results.size();
+
+        runSection (options, "Ratio 1:1 (float-fast)", juce::String::fromUTF8 ("señal"), rows, results,
+                    "   abierta", [] (const CaseResult& r) { return juce::String::formatted (" %7.1f%%", getPathPercent (r, r.paths.open)); });
+
+        for (auto i = numResults; i < results.size(); ++i)
+            if (results[i].paths.closed + results[i].paths.full > 0)
+                std::cout << "Aviso: con ratio 1:1 hay sub-bloques fuera de la ruta abierta (" << getSignalName (results[i].signal)
+                          << ", " << results[i].numChannels << " can, bloque " << results[i].blockSize << ")\n";
+    }
+
+    // --- Multibanda: coste por banda añadida (1 = motor estéreo de banda ancha) ---
+    {
+        std::vector<SectionRow> rows;
+
+        // El caso de 1 banda ya está en la tabla principal: se muestra, no se guarda
+        rows.push_back ({ "1", [&options] (int blockSize)
+                          { return runCase<float> (options, Precision::floatFast, Signal::speechBursts, 2, blockSize); }, false });
+
+        for (int numBands = 2; numBands <= MultibandGateEngine<float>::maxBands; ++numBands)
+            rows.push_back ({ juce::String (numBands), [&options, numBands] (int blockSize)
+                              { return runMultibandCase (options, numBands, Signal::speechBursts, blockSize); } });
+
+        runSection (options, "Multibanda (float-fast, speech-bursts, estéreo)", "bandas", rows, results);
+    }
+
+    // --- Modo espectral: 96 kHz estéreo, trama de 2048 (objetivo: < 10 % de un núcleo) ---
+    {
+        auto spectralOptions = options;
+        spectralOptions.sampleRate = 96000.0;
+
+        const auto frameSize = juce::String (1 << SpectralGateEngine<float>::getOrderForSampleRate (spectralOptions.sampleRate));
+
+        std::vector<SectionRow> rows;
+        rows.push_back ({ frameSize, [spectralOptions] (int blockSize)
+                          { return runSpectralCase (spectralOptions, Signal::speechBursts, blockSize); } });
+
+        runSection (spectralOptions, "Espectral (float-fast, speech-bursts, 96 kHz)", "trama", rows, results,
+                    "  % núcleo", [] (const CaseResult& r)
+                    {
+                        return juce::String::formatted ("  %7.2f%%", 100.0 * r.numChannels / juce::jmax (1.0e-9, r.realtimeFactor));
+                    });
+    }
+
+    // --- Instancias múltiples: preparación y recursos compartidos ---
+    const auto instanceResult = runInstanceCase (options);
+    const auto& pool = instanceResult.pool;
+
+    std::cout << "\nInstancias (SilentRoomAudioProcessor estéreo, "
+              << juce::String (options.sampleRate, 0) << " Hz, bloques de 512)\n"
+              << juce::String::formatted ("%d instancias: construcción %.3f ms por instancia; prepareToPlay: primera %.3f ms, "
+                                          "siguientes %.3f ms de media\n",
+                                          instanceResult.numInstances, instanceResult.constructMs / instanceResult.numInstances,
+                                          instanceResult.firstPrepareMs, instanceResult.meanPrepareMs)
+              << juce::String::formatted ("Recursos compartidos: %d (%.1f KiB, una copia por proceso; sin compartir %.1f KiB), "
+                                          "%llu peticiones, %llu construidos\n",
+                                          pool.numResources, (double) pool.numBytes / 1024.0,
+                                          (double) pool.numBytes * instanceResult.numInstances / 1024.0,
+                                          (unsigned long long) pool.numRequests, (unsigned long long) pool.numCreated);
+
+    if (instanceResult.residentBytes > 0)
+        std::cout << juce::String::formatted ("Memoria (RSS): %.1f MiB (%.1f KiB por instancia)\n",
+                                              (double) instanceResult.residentBytes / (1024.0 * 1024.0),
+                                              (double) instanceResult.residentBytes / 1024.0 / instanceResult.numInstances);
+    else
+        std::cout << "Memoria (RSS): no disponible en esta plataforma\n";
+
+    // --- Resumen: coste relativo entre precisiones y precisión de FastMath ---
+    const auto fastVsExact   = geometricMeanRatio (results, Precision::floatFast, Precision::floatExact);
+    const auto doubleVsFloat = geometricMeanRatio (results, Precision::doublePrecision, Precision::floatExact);
+    const auto doubleVsConverted = geometricMeanRatio (results, Precision::doublePrecision, Precision::doubleViaFloat);
+    const auto accuracy      = FastMath::measureAccuracy();
+
+    std::cout << juce::String::formatted ("\nCoste relativo (media geométrica): float-fast / float-exact = %.3f, double / float-exact = %.3f\n",
+                                          fastVsExact, doubleVsFloat)
+              << juce::String::formatted ("Host en double: double nativo / double-via-float (conversión + motor float) = %.3f\n",
+                                          doubleVsConverted)
+              << juce::String::formatted ("FastMath: error máximo %.2e dB (a dB), %.2e dB (a ganancia), %d puntos\n",
+                                          accuracy.maxGainToDecibelsErrorDb, accuracy.maxDecibelsToGainErrorDb, accuracy.numPoints);
+
+    if (options.jsonFile != juce::File())
+    {
+        juce::Array<juce::var> cases;
+        for (auto& r : results)
+            cases.add (toVar (r));
+
+        auto* fastMath = new juce::DynamicObject();
+        fastMath->setProperty ("maxGainToDecibelsErrorDb", accuracy.maxGainToDecibelsErrorDb);
+        fastMath->setProperty ("maxDecibelsToGainErrorDb", accuracy.maxDecibelsToGainErrorDb);
+        fastMath->setProperty ("numPoints",                accuracy.numPoints);
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("cpu",                 juce::SystemStats::getCpuModel());
+        root->setProperty ("sampleRate",          options.sampleRate);
+        root->setProperty ("secondsPerRepeat",    options.audioSeconds);
+        root->setProperty ("repeats",             options.repeats);
+        root->setProperty ("thresholdDb",         options.params.thresholdDb);
+        root->setProperty ("ratio",               options.params.ratio);
+        root->setProperty ("attackMs",            options.params.attackMs);
+        root->setProperty ("releaseMs",           options.params.releaseMs);
+        root->setProperty ("lookaheadMs",         options.params.lookaheadMs);
+        root->setProperty ("fastVsExactRatio",    fastVsExact);
+        root->setProperty ("doubleVsFloatRatio",  doubleVsFloat);
+        root->setProperty ("doubleVsConvertedRatio", doubleVsConverted);
+        root->setProperty ("fastMathAccuracy",    juce::var (fastMath));
+
+        auto* instances = new juce::DynamicObject();
+        instances->setProperty ("count",            instanceResult.numInstances);
+        instances->setProperty ("constructMs",      instanceResult.constructMs);
+        instances->setProperty ("firstPrepareMs",   instanceResult.firstPrepareMs);
+        instances->setProperty ("meanPrepareMs",    instanceResult.meanPrepareMs);
+        instances->setProperty ("sharedResources",  pool.numResources);
+        instances->setProperty ("sharedBytes",      (juce::int64) pool.numBytes);
+        instances->setProperty ("poolRequests",     (juce::int64) pool.numRequests);
+        instances->setProperty ("poolCreated",      (juce::int64) pool.numCreated);
+        instances->setProperty ("residentBytes",    instanceResult.residentBytes);
+        root->setProperty ("instances",           juce::var (instances));
+        root->setProperty ("results",             cases);
+
+        if (! options.jsonFile.replaceWithText (juce::JSON::toString (juce::var (root))))
+        {
+            std::cerr << "No se puede escribir " << options.jsonFile.getFullPathName() << "\n";
+            return 1;
+        }
+
+        std::cout << "Resultados en " << options.jsonFile.getFullPathName() << "\n";
+    }
+
+    return 0;
+}
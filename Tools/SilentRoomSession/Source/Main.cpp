@@ -0,0 +1,464 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    SilentRoomSession: benchmark de sesión sin DAW. Monta un
+    juce::AudioProcessorGraph con N instancias de SilentRoomAudioProcessor
+    (una por pista estéreo, todas sumadas en un bus máster), lo alimenta con
+    material multipista sintético y lo procesa offline a máxima velocidad,
+    como un host con los editores cerrados:
+
+      - programas de fábrica repartidos entre las instancias (o uno fijo),
+      - automatización de THRESHOLD en cada bloque (desde el hilo de
+        proceso, como la entrega un host),
+      - varios tamaños de bloque y, opcionalmente, bloques de tamaño
+        variable (hosts que parten el buffer en automatizaciones o loops).
+
+    Informa del factor de tiempo real agregado, el coste por instancia
+    (BlockTimingStats de cada procesador), la memoria de la sesión (RSS del
+    proceso) y los tiempos de instanciación y de prepareToPlay del grafo.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/SharedResources.h"
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    //==============================================================================
+    struct SessionOptions
+    {
+        int numInstances = 128;
+        juce::Array<int> blockSizes { 64, 128, 256, 512, 1024 };
+        double sampleRate   = 48000.0;
+        double audioSeconds = 30.0;   // audio de sesión por tamaño de bloque
+        int program = -1;             // -1 = programas repartidos entre instancias
+        bool automation   = true;
+        bool variableBlocks = false;
+        juce::File jsonFile;
+    };
+
+    struct BlockSizeResult
+    {
+        int blockSize = 0;
+        double audioSeconds = 0.0;
+        double wallSeconds  = 0.0;
+        BlockTimingStats::Snapshot perInstance;   // todas las instancias fusionadas
+    };
+
+    //==============================================================================
+    void printUsage()
+    {
+        std::cout << "SilentRoomSession - N instancias de SilentRoom en un AudioProcessorGraph\n\n"
+                     "Uso: SilentRoomSession [opciones]\n\n"
+                     "  --instances <n>       instancias (una por pista estéreo, por defecto 128)\n"
+                     "  --blocks <lista>      tamaños de bloque separados por comas (por defecto 64..1024)\n"
+                     "  --seconds <s>         audio de sesión por tamaño de bloque (por defecto 30)\n"
+                     "  --rate <Hz>           frecuencia de muestreo (por defecto 48000)\n"
+                     "  --program <n>         programa de fábrica para todas (por defecto, repartidos)\n"
+                     "  --no-automation       sin automatización de THRESHOLD\n"
+                     "  --variable-blocks     bloques de tamaño aleatorio hasta el tamaño nominal\n"
+                     "  --json <fichero>      guardar los resultados en JSON\n";
+    }
+
+    bool parseArguments (const juce::StringArray& args, SessionOptions& options, juce::String& error)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto arg  = args[i];
+            const auto name = arg.substring (2).upToFirstOccurrenceOf ("=", false, false);
+            juce::String value;
+
+            if (! arg.startsWith ("--"))
+            {
+                error = "Argumento inesperado: " + arg;
+                return false;
+            }
+
+            if (name == "no-automation")    { options.automation = false; continue; }
+            if (name == "variable-blocks")  { options.variableBlocks = true; continue; }
+
+            if (arg.containsChar ('='))
+                value = arg.fromFirstOccurrenceOf ("=", false, false);
+            else if (i + 1 < args.size())
+                value = args[++i];
+            else
+            {
+                error = "Falta el valor de --" + name;
+                return false;
+            }
+
+            if (name == "instances")     options.numInstances = juce::jlimit (1, 4096, value.getIntValue());
+            else if (name == "blocks")
+            {
+                options.blockSizes.clear();
+
+                for (auto& token : juce::StringArray::fromTokens (value, ",", {}))
+                    options.blockSizes.add (juce::jlimit (16, 1 << 14, token.getIntValue()));
+            }
+            else if (name == "seconds")  options.audioSeconds = juce::jmax (0.1, value.getDoubleValue());
+            else if (name == "rate")     options.sampleRate = juce::jlimit (8000.0, 384000.0, value.getDoubleValue());
+            else if (name == "program")  options.program = value.getIntValue();
+            else if (name == "json")     options.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile (value);
+            else
+            {
+                error = "Opción desconocida: " + arg;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // Memoria residente del proceso en bytes (Linux: /proc/self/statm); 0 si no
+    // se puede leer
+    juce::int64 getResidentBytes()
+    {
+       #if JUCE_LINUX
+        const auto fields = juce::StringArray::fromTokens (juce::File ("/proc/self/statm").loadFileAsString(), " ", {});
+
+        if (fields.size() > 1)
+            return fields[1].getLargeIntValue() * (juce::int64) sysconf (_SC_PAGESIZE);
+       #endif
+
+        return 0;
+    }
+
+    //==============================================================================
+    // Material multipista: unas pocas "tomas" estéreo de 4 s (voz a ráfagas
+    // sobre ruido de fondo, percusión, tono con ruido) que cada pista lee con
+    // su propio desfase y nivel. Se generan una vez para toda la sesión.
+    class SessionMaterial
+    {
+    public:
+        static constexpr int numTakes = 8;
+
+        explicit SessionMaterial (double sampleRate)
+            : length (juce::roundToInt (4.0 * sampleRate))
+        {
+            juce::Random random (0x5e551011);
+
+            for (int t = 0; t < numTakes; ++t)
+            {
+                auto& take = takes[t];
+                take.setSize (2, length);
+
+                const float noiseLevel = juce::Decibels::decibelsToGain (-70.0f + 4.0f * (float) t);
+                const float toneHz     = 110.0f * (float) (t + 1);
+                const double burstRate = 1.5 + 0.5 * t;   // ráfagas por segundo
+
+                for (int i = 0; i < length; ++i)
+                {
+                    const double time  = i / sampleRate;
+                    const double burst = std::sin (juce::MathConstants<double>::pi * std::fmod (time * burstRate, 1.0));
+                    const bool active  = std::fmod (time * burstRate * 0.37, 1.0) < 0.6;
+                    const float tone   = active ? (float) (0.3 * burst * std::sin (juce::MathConstants<double>::twoPi * toneHz * time)) : 0.0f;
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        take.setSample (ch, i, tone + noiseLevel * (random.nextFloat() * 2.0f - 1.0f));
+                }
+            }
+        }
+
+        // Copia numSamples muestras de la pista track (desde position) en dest[0..1]
+        void read (int track, juce::int64 position, float* const* dest, int numSamples) const
+        {
+            const auto& take = takes[track % numTakes];
+            const float gain = juce::Decibels::decibelsToGain (-6.0f * (float) ((track / numTakes) % 4));
+            int offset = (int) ((position + (juce::int64) track * 7919) % length);
+
+            for (int done = 0; done < numSamples;)
+            {
+                const int chunk = juce::jmin (numSamples - done, length - offset);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    juce::FloatVectorOperations::multiply (dest[ch] + done, take.getReadPointer (ch, offset), gain, chunk);
+
+                done  += chunk;
+                offset = 0;
+            }
+        }
+
+    private:
+        const int length;
+        juce::AudioBuffer<float> takes[numTakes];
+    };
+
+    //==============================================================================
+    // Grafo de la sesión: nodo de entrada con 2 canales por pista, una
+    // instancia por pista y todas al bus máster estéreo
+    struct SessionGraph
+    {
+        juce::AudioProcessorGraph graph;
+        std::vector<SilentRoomAudioProcessor*> processors;
+        std::vector<juce::RangedAudioParameter*> thresholds;
+
+        double instantiateMs = 0.0;   // construir N procesadores
+        double connectMs     = 0.0;   // nodos, conexiones y orden de render
+
+        void build (const SessionOptions& options)
+        {
+            const int numInputs = 2 * options.numInstances;
+            graph.setPlayConfigDetails (numInputs, 2, options.sampleRate, options.blockSizes.getFirst());
+
+            using IO = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+            using UpdateKind = juce::AudioProcessorGraph::UpdateKind;
+
+            // 1. Instancias (constructor: APVTS y motores, sin prepare)
+            std::vector<std::unique_ptr<SilentRoomAudioProcessor>> created;
+            auto start = juce::Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < options.numInstances; ++i)
+            {
+                created.push_back (std::make_unique<SilentRoomAudioProcessor>());
+                auto& processor = *created.back();
+
+                const int program = options.program >= 0 ? options.program : i % processor.getNumPrograms();
+                processor.setCurrentProgram (juce::jlimit (0, processor.getNumPrograms() - 1, program));
+            }
+
+            instantiateMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+            // 2. Nodos y conexiones (el orden de render se construye una sola vez)
+            start = juce::Time::getMillisecondCounterHiRes();
+
+            auto input  = graph.addNode (std::make_unique<IO> (IO::audioInputNode),  {}, UpdateKind::none);
+            auto output = graph.addNode (std::make_unique<IO> (IO::audioOutputNode), {}, UpdateKind::none);
+
+            for (int i = 0; i < options.numInstances; ++i)
+            {
+                auto* processor = created[(size_t) i].get();
+                processors.push_back (processor);
+                thresholds.push_back (processor->apvts.getParameter ("THRESHOLD"));
+
+                auto node = graph.addNode (std::move (created[(size_t) i]), {}, UpdateKind::none);
+
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    graph.addConnection ({ { input->nodeID, 2 * i + ch }, { node->nodeID, ch } }, UpdateKind::none);
+                    graph.addConnection ({ { node->nodeID, ch }, { output->nodeID, ch } }, UpdateKind::none);
+                }
+            }
+
+            graph.rebuild();
+            connectMs = juce::Time::getMillisecondCounterHiRes() - start;
+        }
+    };
+
+    //==============================================================================
+    // Procesa options.audioSeconds de sesión con un tamaño de bloque. Solo se
+    // cronometra graph.processBlock (la lectura del material queda fuera).
+    BlockSizeResult runBlockSize (SessionGraph& session, const SessionMaterial& material,
+                                  const SessionOptions& options, int blockSize, double& prepareMs)
+    {
+        BlockSizeResult result;
+        result.blockSize = blockSize;
+
+        auto& graph = session.graph;
+        const int numInstances = (int) session.processors.size();
+
+        graph.releaseResources();
+        const auto prepareStart = juce::Time::getMillisecondCounterHiRes();
+        graph.setPlayConfigDetails (2 * numInstances, 2, options.sampleRate, blockSize);
+        graph.prepareToPlay (options.sampleRate, blockSize);
+        prepareMs = juce::Time::getMillisecondCounterHiRes() - prepareStart;
+
+        for (auto* processor : session.processors)
+            processor->timingStats.reset();
+
+        juce::AudioBuffer<float> buffer (2 * numInstances, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random (blockSize);
+
+        const auto totalSamples = (juce::int64) (options.audioSeconds * options.sampleRate);
+        double processNanos = 0.0;
+
+        for (juce::int64 position = 0; position < totalSamples;)
+        {
+            int numSamples = (int) juce::jmin ((juce::int64) blockSize, totalSamples - position);
+
+            if (options.variableBlocks)
+                numSamples = juce::jmin (numSamples, 1 + random.nextInt (blockSize));
+
+            buffer.setSize (2 * numInstances, numSamples, false, false, true);
+
+            for (int track = 0; track < numInstances; ++track)
+            {
+                float* channels[] = { buffer.getWritePointer (2 * track), buffer.getWritePointer (2 * track + 1) };
+                material.read (track, position, channels, numSamples);
+            }
+
+            // Automatización: THRESHOLD oscila ±10 dB a 0.25 Hz, desfasado por pista
+            if (options.automation)
+            {
+                const double time = (double) position / options.sampleRate;
+
+                for (int i = 0; i < numInstances; ++i)
+                {
+                    auto* threshold = session.thresholds[(size_t) i];
+                    const float db  = -40.0f + 10.0f * (float) std::sin (juce::MathConstants<double>::twoPi * (0.25 * time + i / 16.0));
+                    threshold->setValue (threshold->convertTo0to1 (db));
+                }
+            }
+
+            midi.clear();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            graph.processBlock (buffer, midi);
+            processNanos += juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start) * 1.0e9;
+
+            position += numSamples;
+        }
+
+        result.audioSeconds = (double) totalSamples / options.sampleRate;
+        result.wallSeconds  = processNanos * 1.0e-9;
+
+        for (auto* processor : session.processors)
+            result.perInstance.merge (processor->timingStats.getSnapshot());
+
+        return result;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // El APVTS y el grafo necesitan el hilo de mensajes
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add (juce::CharPointer_UTF8 (argv[i]));
+
+    if (args.contains ("--help") || args.contains ("-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    SessionOptions options;
+    juce::String error;
+
+    if (! parseArguments (args, options, error))
+    {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    const SessionMaterial material (options.sampleRate);
+
+    // --- Sesión: instanciar, conectar y medir la memoria de cada fase ---
+    const auto residentBefore = getResidentBytes();
+
+    SessionGraph session;
+    session.build (options);
+
+    const auto residentBuilt = getResidentBytes();
+
+    std::cout << "SilentRoomSession: " << juce::SystemStats::getCpuModel() << "\n"
+              << juce::String::formatted ("%d instancias, %.0f Hz, %.1f s por tamaño de bloque, %s, automatización %s%s\n\n",
+                                          options.numInstances, options.sampleRate, options.audioSeconds,
+                                          options.program >= 0 ? ("programa " + juce::String (options.program)).toRawUTF8()
+                                                               : "programas repartidos",
+                                          options.automation ? "sí" : "no",
+                                          options.variableBlocks ? ", bloques variables" : "")
+              << juce::String::formatted ("Instanciación: %.2f ms (%.3f ms por instancia); grafo: %.2f ms\n",
+                                          session.instantiateMs, session.instantiateMs / options.numInstances, session.connectMs);
+
+    std::cout << "\nbloque  prepare ms    x RT   % núcleo/inst   us/bloque/inst (media   p99    peor)  fuera de plazo\n";
+
+    std::vector<BlockSizeResult> results;
+    std::vector<double> prepareTimes;
+    juce::int64 residentPrepared = 0;
+
+    for (auto blockSize : options.blockSizes)
+    {
+        double prepareMs = 0.0;
+        const auto r = runBlockSize (session, material, options, blockSize, prepareMs);
+        residentPrepared = juce::jmax (residentPrepared, getResidentBytes());
+
+        const double realtimeFactor = r.audioSeconds / juce::jmax (1.0e-9, r.wallSeconds);
+        const double corePerInstance = 100.0 / realtimeFactor / options.numInstances;
+
+        std::cout << juce::String::formatted ("%6d %11.2f %7.1f %13.3f%%  %21.2f %6.1f %7.1f %15llu\n",
+                                              blockSize, prepareMs, realtimeFactor, corePerInstance,
+                                              r.perInstance.meanMicros, r.perInstance.getPercentileMicros (0.99),
+                                              r.perInstance.worstMicros, (unsigned long long) r.perInstance.deadlineMisses);
+
+        results.push_back (r);
+        prepareTimes.push_back (prepareMs);
+    }
+
+    // --- Memoria ---
+    const auto toMiB = [] (juce::int64 bytes) { return (double) bytes / (1024.0 * 1024.0); };
+
+    if (residentBefore > 0)
+        std::cout << juce::String::formatted ("\nMemoria (RSS): instancias %.1f MiB (%.1f KiB cada una), tras prepareToPlay %.1f MiB (%.1f KiB cada una)\n",
+                                              toMiB (residentBuilt - residentBefore),
+                                              (double) (residentBuilt - residentBefore) / 1024.0 / options.numInstances,
+                                              toMiB (residentPrepared - residentBefore),
+                                              (double) (residentPrepared - residentBefore) / 1024.0 / options.numInstances);
+    else
+        std::cout << "\nMemoria (RSS): no disponible en esta plataforma\n";
+
+    const auto shared = juce::SharedResourcePointer<SharedResourcePool>()->getStats();
+    std::cout << juce::String::formatted ("Tablas compartidas: %d recursos, %.1f KiB en total (%llu peticiones, %llu construidos)\n",
+                                          shared.numResources, (double) shared.numBytes / 1024.0,
+                                          (unsigned long long) shared.numRequests, (unsigned long long) shared.numCreated);
+
+    // --- JSON ---
+    if (options.jsonFile != juce::File())
+    {
+        juce::Array<juce::var> cases;
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            const double realtimeFactor = r.audioSeconds / juce::jmax (1.0e-9, r.wallSeconds);
+
+            auto* obj = new juce::DynamicObject();
+            obj->setProperty ("blockSize",           r.blockSize);
+            obj->setProperty ("prepareMs",           prepareTimes[i]);
+            obj->setProperty ("audioSeconds",        r.audioSeconds);
+            obj->setProperty ("wallSeconds",         r.wallSeconds);
+            obj->setProperty ("realtimeFactor",      realtimeFactor);
+            obj->setProperty ("corePctPerInstance",  100.0 / realtimeFactor / options.numInstances);
+            obj->setProperty ("perInstance",         r.perInstance.toVar());
+            cases.add (juce::var (obj));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("cpu",                    juce::SystemStats::getCpuModel());
+        root->setProperty ("instances",              options.numInstances);
+        root->setProperty ("sampleRate",             options.sampleRate);
+        root->setProperty ("secondsPerBlockSize",    options.audioSeconds);
+        root->setProperty ("program",                options.program);
+        root->setProperty ("automation",             options.automation);
+        root->setProperty ("variableBlocks",         options.variableBlocks);
+        root->setProperty ("instantiateMs",          session.instantiateMs);
+        root->setProperty ("graphBuildMs",           session.connectMs);
+        root->setProperty ("residentInstancesBytes", residentBuilt - residentBefore);
+        root->setProperty ("residentPreparedBytes",  residentPrepared - residentBefore);
+        root->setProperty ("sharedTableBytes",       (juce::int64) shared.numBytes);
+        root->setProperty ("results",                cases);
+
+        if (! options.jsonFile.replaceWithText (juce::JSON::toString (juce::var (root))))
+        {
+            std::cerr << "No se puede escribir " << options.jsonFile.getFullPathName() << "\n";
+            return 1;
+        }
+
+        std::cout << "Resultados en " << options.jsonFile.getFullPathName() << "\n";
+    }
+
+    return 0;
+}